@@ -0,0 +1,257 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "HeadlessEngine.h"
+#include "DungeonGenerator.h"
+#include "DungeonCorpus.h"
+#include "GameJournal.h"
+#include "Tournament.h"
+
+static void printUsage(const char* exe) {
+    printf("Usage: %s [options]\n"
+        "  --games N          dungeons to play (default 1000)\n"
+        "  --seed S           base seed; game i uses S + i (default 1)\n"
+        "  --planner NAME     script|random|bfs|dfs|dijkstra|astar|greedy|mdp (default astar)\n"
+        "  --script KEYS      WASD key sequence for --planner script, repeated up to --max-moves\n"
+        "  --mine-p P         probability a mine question is answered correctly (default 0.7)\n"
+        "  --max-moves N      move cap per game for script/random (default 400)\n"
+        "  --threads N        worker threads (default 1)\n"
+        "  --format FMT       text|json|csv (default text)\n"
+        "  --generate N       only generate N winnable dungeons and report the rate\n"
+        "  --size N           grid size for --generate (default 10)\n"
+        "  --density D        reward/bandit/mine density for --generate (default: 5 of each)\n"
+        "  --write-corpus F   with --generate, also store the winnable dungeons in corpus file F\n"
+        "  --corpus F         play the dungeons of corpus file F (10x10) instead of seeded ones\n"
+        "  --journal F        append a replayable journal of the games to F (single thread, not with --corpus)\n"
+        "  --replay F         fast-forward journal F and report the final states\n"
+        "  --checkpoint-every N  with --replay, print the grid every N records and at game ends\n"
+        "  --tournament N     run all six search algorithms on N seeded dungeons and compare\n", exe);
+}
+
+// One character per cell: P player, $ reward, B bandit, M mine, E exit, . empty.
+static void printGrid(const GameState& state) {
+    const char glyphs[] = ".P$BME*o";
+    for (int y = 0; y < GameState::GRID_SIZE; y++) {
+        for (int x = 0; x < GameState::GRID_SIZE; x++)
+            putchar(glyphs[state.getDisplayCell(x, y) & 7]);
+        putchar('\n');
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    DungeonHeadless::EngineOptions options;
+    std::string format = "text";
+    std::uint64_t generateCount = 0;
+    DungeonGen::GeneratorConfig genConfig;
+    std::string writeCorpus, readCorpus;
+    std::string journalPath, replayPath;
+    std::uint64_t checkpointEvery = 0;
+    std::uint64_t tournamentCount = 0;
+    bool threadsSet = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") { printUsage(argv[0]); return 0; }
+        if (!value) { fprintf(stderr, "Missing value for %s\n", arg.c_str()); return 1; }
+        i++;
+
+        if (arg == "--games") options.games = strtoull(value, nullptr, 10);
+        else if (arg == "--seed") options.seed = strtoull(value, nullptr, 10);
+        else if (arg == "--script") options.script = value;
+        else if (arg == "--mine-p") options.mineSuccessProbability = atof(value);
+        else if (arg == "--max-moves") options.maxMoves = atoi(value);
+        else if (arg == "--threads") { options.threads = atoi(value); threadsSet = true; }
+        else if (arg == "--format") format = value;
+        else if (arg == "--generate") generateCount = strtoull(value, nullptr, 10);
+        else if (arg == "--size") genConfig.width = genConfig.height = atoi(value);
+        else if (arg == "--write-corpus") writeCorpus = value;
+        else if (arg == "--corpus") readCorpus = value;
+        else if (arg == "--journal") journalPath = value;
+        else if (arg == "--replay") replayPath = value;
+        else if (arg == "--tournament") tournamentCount = strtoull(value, nullptr, 10);
+        else if (arg == "--checkpoint-every") checkpointEvery = strtoull(value, nullptr, 10);
+        else if (arg == "--density") genConfig.rewardDensity = genConfig.banditDensity = genConfig.mineDensity = atof(value);
+        else if (arg == "--planner") {
+            if (!DungeonHeadless::parsePlanner(value, options.planner)) {
+                fprintf(stderr, "Unknown planner: %s\n", value);
+                return 1;
+            }
+        }
+        else {
+            fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!journalPath.empty() && !readCorpus.empty()) {
+        fprintf(stderr, "--journal cannot be combined with --corpus: corpus games have no seed to replay\n");
+        return 1;
+    }
+
+    if (!replayPath.empty()) {
+        DungeonJournal::JournalReplayer replayer;
+        if (!replayer.load(replayPath)) {
+            fprintf(stderr, "Cannot replay %s: %s\n", replayPath.c_str(), replayer.getError().c_str());
+            return 1;
+        }
+        DungeonJournal::ReplayOptions replayOptions;
+        replayOptions.checkpointEvery = checkpointEvery;
+        replayOptions.checkpointAtGameEnd = checkpointEvery > 0;
+        std::uint64_t wins = 0, goldSum = 0;
+        DungeonJournal::ReplayStats r = replayer.replay(replayOptions,
+            [&](const DungeonJournal::Checkpoint& cp, const GameState& state) {
+                if (format == "text") {
+                    printf("-- record %llu, game %llu, %s%s: gold %d\n", (unsigned long long)cp.record,
+                        (unsigned long long)cp.game, DungeonJournal::opName(cp.op), cp.gameEnd ? " (game over)" : "",
+                        state.getGold());
+                    printGrid(state);
+                }
+            });
+        // Second pass without rendering for the per-game results.
+        DungeonJournal::ReplayOptions ends;
+        ends.checkpointAtGameEnd = true;
+        replayer.replay(ends, [&](const DungeonJournal::Checkpoint&, const GameState& state) {
+            if (state.hasMetRewardRequirement()) wins++;
+            goldSum += state.getGold();
+            });
+
+        if (format == "json")
+            printf("{\"records\":%llu,\"games\":%llu,\"moves\":%llu,\"mine_answers\":%llu,\"resets\":%llu,"
+                "\"wins\":%llu,\"gold_at_exit\":%llu,\"layout_mismatches\":%llu,\"truncated\":%s,\"seconds\":%.6f}\n",
+                (unsigned long long)r.records, (unsigned long long)r.games, (unsigned long long)r.moves,
+                (unsigned long long)r.mineAnswers, (unsigned long long)r.resets, (unsigned long long)wins,
+                (unsigned long long)goldSum, (unsigned long long)r.layoutMismatches, r.truncated ? "true" : "false", r.seconds);
+        else if (format == "csv")
+            printf("records,games,moves,mine_answers,resets,wins,gold_at_exit,layout_mismatches,truncated,seconds\n"
+                "%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%d,%.6f\n",
+                (unsigned long long)r.records, (unsigned long long)r.games, (unsigned long long)r.moves,
+                (unsigned long long)r.mineAnswers, (unsigned long long)r.resets, (unsigned long long)wins,
+                (unsigned long long)goldSum, (unsigned long long)r.layoutMismatches, r.truncated ? 1 : 0, r.seconds);
+        else {
+            printf("Replayed %llu records (%llu games, %llu moves, %llu mine answers, %llu resets) in %.3f s\n",
+                (unsigned long long)r.records, (unsigned long long)r.games, (unsigned long long)r.moves,
+                (unsigned long long)r.mineAnswers, (unsigned long long)r.resets, r.seconds);
+            printf("Exits with enough gold: %llu, gold at exit: %llu\n", (unsigned long long)wins, (unsigned long long)goldSum);
+            if (r.layoutMismatches) printf("WARNING: %llu games no longer generate the recorded dungeon\n", (unsigned long long)r.layoutMismatches);
+            if (r.truncated) printf("WARNING: journal ends inside a record\n");
+        }
+        return r.layoutMismatches ? 2 : 0;
+    }
+
+    if (tournamentCount > 0) {
+        DungeonTournament::TournamentOptions t;
+        t.dungeons = tournamentCount;
+        t.seed = options.seed;
+        t.threads = threadsSet ? options.threads : 0;
+        t.mineSuccessProbability = options.mineSuccessProbability;
+        DungeonTournament::TournamentResult r = DungeonTournament::run(t);
+        if (format == "json") DungeonTournament::writeJson(stdout, r);
+        else if (format == "csv") DungeonTournament::writeCsv(stdout, r);
+        else fputs(DungeonTournament::formatTable(r).c_str(), stdout);
+        return 0;
+    }
+
+    if (generateCount > 0) {
+        DungeonGen::DungeonGenerator generator(genConfig);
+        DungeonGen::Dungeon dungeon;
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(options.seed));
+        DungeonCorpus::CorpusWriter writer;
+        if (!writeCorpus.empty() && !writer.open(writeCorpus, generator.getConfig().width, generator.getConfig().height)) {
+            fprintf(stderr, "Cannot write corpus: %s\n", writeCorpus.c_str());
+            return 1;
+        }
+        std::uint64_t failed = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < generateCount; i++) {
+            if (!generator.generate(rng, dungeon)) {
+                failed++;
+                continue;
+            }
+            if (!writeCorpus.empty() && !writer.append(dungeon)) {
+                fprintf(stderr, "Cannot write corpus: %s\n", writeCorpus.c_str());
+                return 1;
+            }
+        }
+        if (!writeCorpus.empty() && !writer.finish()) {
+            fprintf(stderr, "Cannot write corpus: %s\n", writeCorpus.c_str());
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        double rate = seconds > 0.0 ? generateCount / seconds : 0.0;
+
+        if (format == "json")
+            printf("{\"generated\":%llu,\"size\":%d,\"failed\":%llu,\"seconds\":%.6f,\"dungeons_per_second\":%.0f}\n",
+                (unsigned long long)generateCount, genConfig.width, (unsigned long long)failed, seconds, rate);
+        else if (format == "csv")
+            printf("generated,size,failed,seconds,dungeons_per_second\n%llu,%d,%llu,%.6f,%.0f\n",
+                (unsigned long long)generateCount, genConfig.width, (unsigned long long)failed, seconds, rate);
+        else
+            printf("Generated %llu %dx%d dungeons (%llu not winnable) in %.3f s: %.0f dungeons/s\n",
+                (unsigned long long)generateCount, genConfig.width, genConfig.height, (unsigned long long)failed, seconds, rate);
+        return 0;
+    }
+
+    DungeonCorpus::CorpusReader corpus;
+    if (!readCorpus.empty()) {
+        if (!corpus.open(readCorpus)) {
+            fprintf(stderr, "Cannot read corpus %s: %s\n", readCorpus.c_str(), corpus.getError().c_str());
+            return 1;
+        }
+        if (corpus.width() != GameState::GRID_SIZE || corpus.height() != GameState::GRID_SIZE || corpus.size() == 0) {
+            fprintf(stderr, "Corpus %s is not a non-empty %dx%d corpus\n", readCorpus.c_str(), GameState::GRID_SIZE, GameState::GRID_SIZE);
+            return 1;
+        }
+        options.corpus = &corpus;
+    }
+
+    DungeonJournal::JournalWriter journal;
+    if (!journalPath.empty()) {
+        if (!journal.open(journalPath)) {
+            fprintf(stderr, "Cannot write journal: %s\n", journalPath.c_str());
+            return 1;
+        }
+        journal.setAutoFlush(false);
+        options.journal = &journal;
+    }
+
+    DungeonHeadless::HeadlessEngine engine(options);
+    DungeonHeadless::EngineStats s = engine.run();
+    const char* planner = DungeonHeadless::plannerName(options.planner);
+
+    if (format == "json") {
+        printf("{\"planner\":\"%s\",\"games\":%llu,\"seed\":%llu,\"wins\":%llu,\"poor_exits\":%llu,\"stuck\":%llu,"
+            "\"win_rate\":%.6f,\"mean_gold\":%.4f,\"moves\":%llu,\"rewards\":%llu,\"bandits\":%llu,\"mines\":%llu,"
+            "\"mines_failed\":%llu,\"seconds\":%.6f,\"plan_seconds\":%.6f,\"move_seconds\":%.6f,\"moves_per_second\":%.0f}\n",
+            planner, (unsigned long long)s.games, (unsigned long long)options.seed, (unsigned long long)s.wins,
+            (unsigned long long)s.poorExits, (unsigned long long)s.stuck, s.winRate(), s.meanGold(),
+            (unsigned long long)s.moves, (unsigned long long)s.rewards, (unsigned long long)s.bandits,
+            (unsigned long long)s.mines, (unsigned long long)s.minesFailed, s.seconds, s.planSeconds, s.moveSeconds,
+            s.movesPerSecond());
+    }
+    else if (format == "csv") {
+        printf("planner,games,seed,wins,poor_exits,stuck,win_rate,mean_gold,moves,rewards,bandits,mines,mines_failed,"
+            "seconds,plan_seconds,move_seconds,moves_per_second\n");
+        printf("%s,%llu,%llu,%llu,%llu,%llu,%.6f,%.4f,%llu,%llu,%llu,%llu,%llu,%.6f,%.6f,%.6f,%.0f\n",
+            planner, (unsigned long long)s.games, (unsigned long long)options.seed, (unsigned long long)s.wins,
+            (unsigned long long)s.poorExits, (unsigned long long)s.stuck, s.winRate(), s.meanGold(),
+            (unsigned long long)s.moves, (unsigned long long)s.rewards, (unsigned long long)s.bandits,
+            (unsigned long long)s.mines, (unsigned long long)s.minesFailed, s.seconds, s.planSeconds, s.moveSeconds,
+            s.movesPerSecond());
+    }
+    else {
+        printf("Planner:        %s\n", planner);
+        printf("Games:          %llu (seed %llu)\n", (unsigned long long)s.games, (unsigned long long)options.seed);
+        printf("Wins:           %llu (%.2f%%)\n", (unsigned long long)s.wins, s.winRate() * 100.0);
+        printf("Poor exits:     %llu\n", (unsigned long long)s.poorExits);
+        printf("Stuck:          %llu\n", (unsigned long long)s.stuck);
+        printf("Mean gold:      %.2f\n", s.meanGold());
+        printf("Moves:          %llu (%.0f moves/s)\n", (unsigned long long)s.moves, s.movesPerSecond());
+        printf("Mines:          %llu (%llu failed)\n", (unsigned long long)s.mines, (unsigned long long)s.minesFailed);
+        printf("Time:           %.3f s (plan %.3f s, moves %.3f s)\n", s.seconds, s.planSeconds, s.moveSeconds);
+    }
+    return 0;
+}
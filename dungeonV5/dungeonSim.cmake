@@ -0,0 +1,28 @@
+# dungeonSim.cmake
+# Headless simulator: GameState + planners without natGUI
+set(SIM_NAME dungeonSim)
+
+set(SIM_SOURCES ${CMAKE_CURRENT_LIST_DIR}/cli/main.cpp)
+set(SIM_INCS
+    ${CMAKE_CURRENT_LIST_DIR}/src/GameState.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/GridView.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/DungeonGenerator.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/SearchProgress.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/Algorithms.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/DungeonCorpus.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/GameJournal.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/Rollout.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/HeadlessEngine.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/Tournament.h)
+
+add_executable(${SIM_NAME} ${SIM_SOURCES} ${SIM_INCS})
+target_include_directories(${SIM_NAME} PRIVATE ${CMAKE_CURRENT_LIST_DIR}/src)
+target_compile_features(${SIM_NAME} PRIVATE cxx_std_17)
+
+find_package(Threads REQUIRED)
+target_link_libraries(${SIM_NAME} Threads::Threads)
+
+if(MSVC)
+    source_group("inc"            FILES ${SIM_INCS})
+	source_group("src"        FILES ${SIM_SOURCES})
+endif()
@@ -9,6 +9,13 @@
 #include <climits>
 #include <limits>
 #include <cstring> 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <chrono>
+#include "GridView.h"
+#include "SearchProgress.h"
 
 
 namespace DungeonMDP {
@@ -24,134 +31,439 @@ namespace DungeonMDP {
     constexpr double THETA = 0.0001;
     constexpr int MAX_ITERATIONS = 5000;
 
+    constexpr size_t STORAGE_ALIGNMENT = 64;
+    constexpr size_t DEFAULT_MEMORY_BUDGET = size_t(96) << 20;
+
     enum Action { RIGHT = 0, LEFT = 1, DOWN = 2, UP = 3, NUM_ACTIONS = 4 };
 
+    enum class Precision : std::uint8_t { Double, Float };
+
+    struct MDPOptions {
+        Precision precision = Precision::Double;
+        int maxGold = MAX_GOLD_TRACKED;
+        size_t memoryBudget = DEFAULT_MEMORY_BUDGET;
+        bool allowDowngrade = true;     // fall back to float values before refusing
+        double gamma = GAMMA;
+        double theta = THETA;
+        int maxIterations = MAX_ITERATIONS;
+        // Stop once the greedy policy is epsilon-optimal: max |V' - V| < epsilon * (1 - gamma) / (2 * gamma)
+        // (Puterman, Thm 6.3.1; the bound also holds for in-place Gauss-Seidel sweeps, sec. 6.3.3).
+        // Epsilon is in value units; 0 keeps only the theta test.
+        double epsilon = 0.5;
+        // Off: never read from, warm-start from, or add to the shared MDPCache, so the
+        // work done depends only on this layout (used by the tournament).
+        bool useCache = true;
+    };
+
+    struct MDPTelemetry {
+        std::vector<double> residuals;      // max |V' - V| per sweep
+        int iterations = 0;
+        double seconds = 0.0;
+        double secondsPerSweep = 0.0;
+        double backupsPerSecond = 0.0;      // state backups (all actions of one state)
+        std::uint64_t backups = 0;          // state backups over all sweeps
+        bool converged = false;             // residual dropped below theta
+        bool epsilonOptimal = false;        // stopped by the sup-norm epsilon bound
+        bool warmStarted = false;
+    };
+
     struct MDPResult {
         std::vector<std::pair<int, int>> path;
         std::vector<std::pair<int, int>> exploredNodes;
-        double expectedValue;
-        bool solutionFound;
+        double expectedValue = 0.0;
+        bool solutionFound = false;
+        bool overBudget = false;
+        Precision precision = Precision::Double;
+        size_t memoryBytes = 0;
+        bool cacheHit = false;
+        bool cancelled = false;             // stopped through SearchProgress; path and values are partial
+        MDPTelemetry telemetry;             // from the solve that produced the cached solution
     };
 
-    class MDPSolver {
-    private:
-        const int(*grid)[GRID_SIZE];
-        int startX, startY, startGold;
-        std::pair<int, int> exitPos;
+    inline size_t alignUp(size_t bytes) {
+        return (bytes + STORAGE_ALIGNMENT - 1) & ~(STORAGE_ALIGNMENT - 1);
+    }
 
-        
-        double V[GRID_SIZE][GRID_SIZE][MAX_GOLD_TRACKED + 1];
-        Action policy[GRID_SIZE][GRID_SIZE][MAX_GOLD_TRACKED + 1];
+    inline size_t valueBytes(Precision p) {
+        return p == Precision::Float ? sizeof(float) : sizeof(double);
+    }
 
-        inline bool isValid(int x, int y) const {
-            return x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE;
-        }
+    // V followed by a one-byte-per-state policy, in one aligned allocation.
+    inline size_t storageBytes(size_t states, Precision p) {
+        return alignUp(states * valueBytes(p)) + alignUp(states);
+    }
 
-        inline int clampGold(int g) const {
-            if (g < 0) return 0;
-            if (g > MAX_GOLD_TRACKED) return MAX_GOLD_TRACKED;
-            return g;
+    // Picks the precision to solve with under the memory budget. Returns false when
+    // even the smallest allowed representation does not fit.
+    inline bool choosePrecision(size_t states, const MDPOptions& options, Precision& out) {
+        out = options.precision;
+        if (storageBytes(states, out) <= options.memoryBudget) return true;
+        if (out == Precision::Double && options.allowDowngrade) {
+            out = Precision::Float;
+            return storageBytes(states, out) <= options.memoryBudget;
         }
+        return false;
+    }
 
-        inline double getReward(int cellType, int currentGold, int newGold) const {
+    class AlignedBlock {
+    private:
+        struct Free {
+            void operator()(unsigned char* p) const { ::operator delete(p, std::align_val_t(STORAGE_ALIGNMENT)); }
+        };
+        std::unique_ptr<unsigned char, Free> data;
+        size_t bytes = 0;
+
+    public:
+        explicit AlignedBlock(size_t n)
+            : data(static_cast<unsigned char*>(::operator new(n, std::align_val_t(STORAGE_ALIGNMENT)))), bytes(n) {}
+
+        unsigned char* get() const { return data.get(); }
+        size_t size() const { return bytes; }
+    };
+
+    // Grid compiled into flat transition tables so the Bellman backup is a branch-free
+    // gather-multiply-add. Tables are factored to stay small on large maps: each
+    // (cell, action) pair stores its successor cell and an outcome kind, and each
+    // (kind, gold) pair stores the expected reward plus two (gold offset, probability)
+    // outcomes. Deterministic moves use probability 1 and 0 on the same successor.
+    // Nothing here depends on gamma or theta, so one model serves any solve settings.
+    struct MDPModel {
+        // Kinds 0-5 are the tile types the move leaves from; then these two.
+        static constexpr int KIND_OTHER = 6;
+        static constexpr int KIND_BLOCKED = 7;
+        static constexpr int NUM_KINDS = 8;
+
+        struct Outcome {
+            double reward;
+            double prob[2];
+            std::int32_t gold[2];
+        };
+
+        int width = 0, height = 0, maxGold = 0;
+        std::pair<int, int> exitPos;
+        std::vector<std::uint32_t> activeCells;     // every cell except the exit, in sweep order
+        std::vector<std::uint32_t> successor;       // [cell * NUM_ACTIONS + a] -> successor cell
+        std::vector<std::uint8_t> kind;             // [cell * NUM_ACTIONS + a] -> outcome kind
+        std::vector<Outcome> outcomes;              // [kind * (maxGold + 1) + g]
+
+        int goldStates() const { return maxGold + 1; }
+
+        const Outcome& outcome(int k, int g) const { return outcomes[(size_t)k * goldStates() + g]; }
+
+        static double reward(int cellType, int currentGold, int newGold, int maxGold) {
             // 0:Empty, 1:Player, 2:Reward, 3:Bandit, 4:Mine, 5:Exit
             if (cellType == 0) return -0.05;
             if (cellType == 1) return 0.0;
-            if (cellType == 2) return (currentGold >= MAX_GOLD_TRACKED) ? -0.05 : 150.0;
+            if (cellType == 2) return (currentGold >= maxGold) ? -0.05 : 150.0;
             if (cellType == 3) return -50.0 - (currentGold - newGold) * 5.0;
             if (cellType == 4) return -10.0;
             return -0.1; 
         }
 
-        void initialize() {
-            for (int x = 0; x < GRID_SIZE; x++) {
-                for (int y = 0; y < GRID_SIZE; y++) {
-                    for (int g = 0; g <= MAX_GOLD_TRACKED; g++) {
-                        V[x][y][g] = 0.0;
-                        policy[x][y][g] = RIGHT;
+        static std::shared_ptr<const MDPModel> compile(const GridView& grid, std::pair<int, int> exit, int maxGold) {
+            auto model = std::make_shared<MDPModel>();
+            model->width = grid.width;
+            model->height = grid.height;
+            model->maxGold = maxGold;
+            model->exitPos = exit;
+
+            const int G = maxGold + 1;
+            auto clamp = [maxGold](int g) { return std::max(0, std::min(g, maxGold)); };
+
+            model->outcomes.resize((size_t)NUM_KINDS * G);
+            for (int k = 0; k < NUM_KINDS; k++) {
+                for (int g = 0; g < G; g++) {
+                    Outcome& o = model->outcomes[(size_t)k * G + g];
+                    int next = g;
+                    if (k == 2) next = clamp(g + 10);
+                    else if (k == 3) next = clamp(g / 2);
+
+                    o.prob[0] = 1.0;
+                    o.prob[1] = 0.0;
+                    o.gold[0] = o.gold[1] = next;
+                    if (k == KIND_BLOCKED) o.reward = -1.0;
+                    else o.reward = reward(k == KIND_OTHER ? -1 : k, g, next, maxGold);
+
+                    if (k == 4) {
+                        o.prob[0] = MINE_SUCCESS_PROBABILITY;
+                        o.prob[1] = 1.0 - MINE_SUCCESS_PROBABILITY;
+                        o.gold[1] = clamp(g - 5);
                     }
                 }
             }
 
+            size_t cells = grid.cellCount();
+            model->successor.resize(cells * NUM_ACTIONS);
+            model->kind.resize(cells * NUM_ACTIONS);
+            model->activeCells.reserve(cells);
+            for (int x = 0; x < grid.width; x++) {
+                for (int y = 0; y < grid.height; y++) {
+                    std::uint32_t c = (std::uint32_t)((size_t)x * grid.height + y);
+                    if (x != exit.first || y != exit.second) model->activeCells.push_back(c);
+
+                    int cell = grid.at(x, y);
+                    int cellKind = (cell >= 0 && cell <= 5) ? cell : KIND_OTHER;
+                    for (int a = 0; a < NUM_ACTIONS; a++) {
+                        int nx = x + DIRECTIONS[a][0];
+                        int ny = y + DIRECTIONS[a][1];
+                        size_t t = (size_t)c * NUM_ACTIONS + a;
+                        if (grid.contains(nx, ny)) {
+                            model->successor[t] = (std::uint32_t)((size_t)nx * grid.height + ny);
+                            model->kind[t] = (std::uint8_t)cellKind;
+                        }
+                        else {
+                            model->successor[t] = c;
+                            model->kind[t] = KIND_BLOCKED;
+                        }
+                    }
+                }
+            }
+            return model;
+        }
+    };
+
+    // Converged value function and policy for one dungeon layout. Neither depends
+    // on the starting gold, so a single entry answers queries for any startGold.
+    struct MDPSolution {
+        std::uint64_t solutionHash = 0;
+        int width = 0, height = 0, maxGold = 0;
+        std::pair<int, int> exitPos;
+        std::vector<std::uint8_t> tiles;
+        Precision precision;
+        double gamma = GAMMA, theta = THETA, epsilon = 0.0;
+        std::shared_ptr<const MDPModel> model;
+        MDPTelemetry telemetry;
+        AlignedBlock storage;
+
+        MDPSolution(int w, int h, int goldRange, Precision p)
+            : width(w), height(h), maxGold(goldRange), precision(p)
+            , storage(storageBytes((size_t)w * h * (goldRange + 1), p)) {}
+
+        size_t states() const { return (size_t)width * height * (maxGold + 1); }
+        size_t index(int x, int y, int g) const { return ((size_t)x * height + y) * (maxGold + 1) + g; }
+
+        template <typename Value> Value* values() { return reinterpret_cast<Value*>(storage.get()); }
+        template <typename Value> const Value* values() const { return reinterpret_cast<const Value*>(storage.get()); }
+        std::uint8_t* policy() { return storage.get() + alignUp(states() * valueBytes(precision)); }
+        const std::uint8_t* policy() const { return storage.get() + alignUp(states() * valueBytes(precision)); }
+
+        double value(size_t i) const {
+            return precision == Precision::Float ? (double)values<float>()[i] : values<double>()[i];
+        }
+
+        bool sameLayout(const GridView& grid) const {
+            if (grid.width != width || grid.height != height) return false;
+            for (int x = 0; x < width; x++)
+                for (int y = 0; y < height; y++)
+                    if (tiles[(size_t)x * height + y] != grid.at(x, y)) return false;
+            return true;
+        }
+    };
+
+    // Cache key of a solution: FNV-1a over the grid size, tile layout and exit position.
+    // Not GameState::layoutHash, which also covers the start cell and only exists for
+    // GRID_SIZE grids; a solved policy serves every start on the same tiles and exit.
+    inline std::uint64_t solutionHash(const GridView& grid, std::pair<int, int> exit) {
+        std::uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](int v) {
+            for (int i = 0; i < 4; i++) { h ^= (static_cast<std::uint32_t>(v) >> (8 * i)) & 0xFF; h *= 1099511628211ull; }
+        };
+        mix(grid.width);
+        mix(grid.height);
+        for (int x = 0; x < grid.width; x++)
+            for (int y = 0; y < grid.height; y++) mix(grid.at(x, y));
+        mix(exit.first);
+        mix(exit.second);
+        return h;
+    }
+
+    // Small LRU of solved layouts shared by every MDPSolver. An exact hit skips value
+    // iteration entirely; a near miss (same exit, few differing cells) seeds V so the
+    // solver warm-starts instead of iterating up from zero.
+    class MDPCache {
+    public:
+        static constexpr size_t CAPACITY = 16;
+        static constexpr size_t MAX_BYTES = size_t(256) << 20;
+
+        static MDPCache& instance() {
+            static MDPCache cache;
+            return cache;
+        }
+
+        std::shared_ptr<const MDPSolution> find(std::uint64_t hash, const GridView& grid,
+            std::pair<int, int> exit, const MDPOptions& options, Precision precision) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < entries.size(); i++) {
+                const auto& e = entries[i];
+                // A double solution also answers float queries, never the other way round.
+                bool precise = e->precision == precision || e->precision == Precision::Double;
+                if (e->solutionHash == hash && e->exitPos == exit && e->maxGold == options.maxGold &&
+                    e->gamma == options.gamma && e->theta == options.theta && e->epsilon == options.epsilon &&
+                    precise && e->sameLayout(grid)) {
+                    auto hit = e;
+                    entries.erase(entries.begin() + i);
+                    entries.insert(entries.begin(), hit);
+                    return hit;
+                }
+            }
+            return nullptr;
+        }
+
+        std::shared_ptr<const MDPSolution> nearest(const GridView& grid, std::pair<int, int> exit, int maxGold) {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::shared_ptr<const MDPSolution> best;
+            size_t bestDiff = grid.cellCount() / 4 + 1;
+            for (const auto& e : entries) {
+                if (e->exitPos != exit || e->maxGold != maxGold) continue;
+                if (e->width != grid.width || e->height != grid.height) continue;
+                size_t diff = 0;
+                for (int x = 0; x < grid.width && diff < bestDiff; x++)
+                    for (int y = 0; y < grid.height; y++)
+                        if (e->tiles[(size_t)x * grid.height + y] != grid.at(x, y)) diff++;
+                if (diff < bestDiff) {
+                    bestDiff = diff;
+                    best = e;
+                }
+            }
+            return best;
+        }
+
+        void insert(const std::shared_ptr<const MDPSolution>& solution) {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.insert(entries.begin(), solution);
+            size_t bytes = 0;
+            for (const auto& e : entries) bytes += e->storage.size();
+            while (entries.size() > 1 && (entries.size() > CAPACITY || bytes > MAX_BYTES)) {
+                bytes -= entries.back()->storage.size();
+                entries.pop_back();
+            }
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.clear();
+        }
+
+    private:
+        MDPCache() = default;
+
+        std::mutex mutex;
+        std::vector<std::shared_ptr<const MDPSolution>> entries;
+    };
+
+    class MDPSolver {
+    private:
+        GridView grid;
+        std::pair<int, int> exitPos;
+        int startX, startY, startGold;
+        MDPOptions options;
+        std::shared_ptr<const MDPModel> compiled;
+        SearchProgress* progress = nullptr;
+
+        std::shared_ptr<MDPSolution> solution;
+        std::shared_ptr<const MDPSolution> solved;
+
+        inline bool isValid(int x, int y) const {
+            return grid.contains(x, y);
+        }
+
+        inline int clampGold(int g) const {
+            if (g < 0) return 0;
+            if (g > options.maxGold) return options.maxGold;
+            return g;
+        }
+
+        template <typename Value>
+        void initialize(const MDPSolution* warmStart) {
+            Value* V = solution->values<Value>();
+            std::uint8_t* policy = solution->policy();
+            size_t states = solution->states();
+
+            if (warmStart) {
+                for (size_t i = 0; i < states; i++) V[i] = (Value)warmStart->value(i);
+                memcpy(policy, warmStart->policy(), states);
+            }
+            else {
+                std::fill(V, V + states, (Value)0);
+                memset(policy, RIGHT, states);
+            }
+
             int ex = exitPos.first;
             int ey = exitPos.second;
-            for (int g = 0; g <= MAX_GOLD_TRACKED; g++) {
+            for (int g = 0; g <= options.maxGold; g++) {
                 if (g < MIN_GOLD_FOR_WIN) {
-                    V[ex][ey][g] = -10000.0; 
+                    V[solution->index(ex, ey, g)] = (Value)-10000.0;
                 }
                 else {
                     double extra = (double)(g - MIN_GOLD_FOR_WIN);
-                    V[ex][ey][g] = 2000.0 + (extra * 100.0); 
+                    V[solution->index(ex, ey, g)] = (Value)(2000.0 + (extra * 100.0));
                 }
             }
         }
 
-        void valueIteration() {
-            int ex = exitPos.first;
-            int ey = exitPos.second;
-
-            for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
+        template <typename Value>
+        void valueIteration(const MDPModel& model) {
+            Value* V = solution->values<Value>();
+            std::uint8_t* policy = solution->policy();
+            const int G = model.goldStates();
+            const double gamma = options.gamma;
+            const MDPModel::Outcome* outcomes = model.outcomes.data();
+            const std::uint32_t* successor = model.successor.data();
+            const std::uint8_t* kind = model.kind.data();
+
+            MDPTelemetry& telemetry = solution->telemetry;
+            const double epsilonBound = options.epsilon > 0.0 ? options.epsilon * (1.0 - gamma) / (2.0 * gamma) : 0.0;
+            auto start = std::chrono::steady_clock::now();
+
+            for (int iter = 0; iter < options.maxIterations; iter++) {
                 double maxDelta = 0.0;
 
-                for (int x = 0; x < GRID_SIZE; x++) {
-                    for (int y = 0; y < GRID_SIZE; y++) {
-
-                        
-                        if (x == ex && y == ey) continue;
-
-                        int cell = grid[x][y];
-
-                        for (int g = 0; g <= MAX_GOLD_TRACKED; g++) {
-                            double currentVal = V[x][y][g];
-                            double bestValue = -std::numeric_limits<double>::infinity();
-                            Action bestAction = RIGHT;
-
-                            for (int a = 0; a < NUM_ACTIONS; a++) {
-                                int nx = x + DIRECTIONS[a][0];
-                                int ny = y + DIRECTIONS[a][1];
-                                double actionValue = 0.0;
-
-                                if (!isValid(nx, ny)) {
-                                    actionValue = -1.0 + GAMMA * V[x][y][g];
-                                }
-                                else {
-                                    if (cell == 4) {
-                                        double valSuccess = getReward(4, g, g) + GAMMA * V[nx][ny][g];
-                                        int gFail = clampGold(g - 5);
-                                        double valFail = getReward(4, g, gFail) + GAMMA * V[nx][ny][gFail];
-
-                                        actionValue = (MINE_SUCCESS_PROBABILITY * valSuccess) +
-                                            ((1.0 - MINE_SUCCESS_PROBABILITY) * valFail);
-                                    }
-                                   
-                                    else {
-                                        int nextGold = g;
-                                        if (cell == 2) nextGold = clampGold(g + 10);
-                                        else if (cell == 3) nextGold = clampGold(g / 2);
-
-                                        actionValue = getReward(cell, g, nextGold) + GAMMA * V[nx][ny][nextGold];
-                                    }
-                                }
-
-                                if (actionValue > bestValue) {
-                                    bestValue = actionValue;
-                                    bestAction = static_cast<Action>(a);
-                                }
-                            }
-
-                            V[x][y][g] = bestValue;
-                            policy[x][y][g] = bestAction;
-
-                            double diff = std::abs(currentVal - bestValue);
-                            if (diff > maxDelta) maxDelta = diff;
+                for (std::uint32_t c : model.activeCells) {
+                    Value* here = V + (size_t)c * G;
+                    std::uint8_t* act = policy + (size_t)c * G;
+                    const Value* next[NUM_ACTIONS];
+                    const MDPModel::Outcome* out[NUM_ACTIONS];
+                    for (int a = 0; a < NUM_ACTIONS; a++) {
+                        next[a] = V + (size_t)successor[(size_t)c * NUM_ACTIONS + a] * G;
+                        out[a] = outcomes + (size_t)kind[(size_t)c * NUM_ACTIONS + a] * G;
+                    }
+
+                    for (int g = 0; g < G; g++) {
+                        double bestValue = -std::numeric_limits<double>::infinity();
+                        int bestAction = RIGHT;
+
+                        for (int a = 0; a < NUM_ACTIONS; a++) {
+                            const MDPModel::Outcome& o = out[a][g];
+                            double actionValue = o.reward + gamma *
+                                (o.prob[0] * next[a][o.gold[0]] + o.prob[1] * next[a][o.gold[1]]);
+                            bool better = actionValue > bestValue;
+                            bestValue = better ? actionValue : bestValue;
+                            bestAction = better ? a : bestAction;
                         }
+
+                        double diff = std::abs(bestValue - (double)here[g]);
+                        maxDelta = diff > maxDelta ? diff : maxDelta;
+                        here[g] = (Value)bestValue;
+                        act[g] = (std::uint8_t)bestAction;
                     }
                 }
-                if (maxDelta < THETA) break;
+
+                telemetry.residuals.push_back(maxDelta);
+                telemetry.iterations = iter + 1;
+                if (progress && progress->sweep(maxDelta)) break;
+                if (maxDelta < options.theta) { telemetry.converged = true; break; }
+                if (maxDelta < epsilonBound) { telemetry.epsilonOptimal = true; break; }
             }
+
+            telemetry.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (telemetry.iterations > 0) telemetry.secondsPerSweep = telemetry.seconds / telemetry.iterations;
+            telemetry.backups = (std::uint64_t)model.activeCells.size() * G * telemetry.iterations;
+            if (telemetry.seconds > 0.0)
+                telemetry.backupsPerSecond = (double)telemetry.backups / telemetry.seconds;
         }
 
         std::vector<std::pair<int, int>> extractPath() const {
+            const std::uint8_t* policy = solved->policy();
             std::vector<std::pair<int, int>> path;
             int cx = startX, cy = startY;
             int cg = clampGold(startGold);
@@ -159,16 +471,17 @@ namespace DungeonMDP {
             path.push_back({ cx, cy });
 
             
-            for (int step = 0; step < 200; step++) {
+            int maxSteps = std::max(200, grid.width * grid.height);
+            for (int step = 0; step < maxSteps; step++) {
                 if (cx == exitPos.first && cy == exitPos.second) break;
 
-                Action a = policy[cx][cy][cg];
+                Action a = static_cast<Action>(policy[solved->index(cx, cy, cg)]);
                 int nx = cx + DIRECTIONS[a][0];
                 int ny = cy + DIRECTIONS[a][1];
 
                 if (!isValid(nx, ny)) break;
 
-                int cell = grid[nx][ny];
+                int cell = grid.at(nx, ny);
                 if (cell == 2) cg += 10;
                 else if (cell == 3) cg /= 2;
                 cg = clampGold(cg);
@@ -184,26 +497,102 @@ namespace DungeonMDP {
             std::pair<int, int> start,
             std::pair<int, int> exit,
             int initialGold)
-            : grid(gridIn), exitPos(exit), startX(start.first), startY(start.second), startGold(initialGold) {
-            initialize();
+            : MDPSolver(GridView(gridIn), start, exit, initialGold) {
         }
 
+        MDPSolver(const GridView& gridIn,
+            std::pair<int, int> start,
+            std::pair<int, int> exit,
+            int initialGold,
+            const MDPOptions& opts = MDPOptions())
+            : grid(gridIn), exitPos(exit), startX(start.first), startY(start.second), startGold(initialGold), options(opts) {
+            if (options.maxGold < MIN_GOLD_FOR_WIN) options.maxGold = MIN_GOLD_FOR_WIN;
+        }
+
+        // Reuses a model compiled earlier (e.g. to sweep gamma/theta on one layout).
+        // The grid must outlive the solver and match the one the model was built from.
+        MDPSolver(std::shared_ptr<const MDPModel> model,
+            const GridView& gridIn,
+            std::pair<int, int> start,
+            int initialGold,
+            const MDPOptions& opts = MDPOptions())
+            : MDPSolver(gridIn, start, model->exitPos, initialGold, opts) {
+            options.maxGold = model->maxGold;
+            compiled = std::move(model);
+        }
+
+        // Reports sweeps and residuals to p and stops early once it is cancelled.
+        // A cancelled solve is not added to the cache.
+        void setProgress(SearchProgress* p) { progress = p; }
+
         MDPResult solve() {
-            valueIteration();
             MDPResult result;
+            size_t states = grid.cellCount() * (options.maxGold + 1);
+            Precision precision;
+            if (!choosePrecision(states, options, precision)) {
+                result.overBudget = true;
+                result.memoryBytes = storageBytes(states, Precision::Float);
+                return result;
+            }
+
+            MDPCache& cache = MDPCache::instance();
+            std::uint64_t hash = solutionHash(grid, exitPos);
+
+            solved = options.useCache ? cache.find(hash, grid, exitPos, options, precision) : nullptr;
+            result.cacheHit = solved != nullptr;
+            if (!solved) {
+                solution = std::make_shared<MDPSolution>(grid.width, grid.height, options.maxGold, precision);
+                solution->solutionHash = hash;
+                solution->exitPos = exitPos;
+                solution->tiles.resize(grid.cellCount());
+                for (int x = 0; x < grid.width; x++)
+                    for (int y = 0; y < grid.height; y++)
+                        solution->tiles[(size_t)x * grid.height + y] = (std::uint8_t)grid.at(x, y);
+
+                auto warmStart = options.useCache ? cache.nearest(grid, exitPos, options.maxGold) : nullptr;
+                if (!compiled && warmStart && warmStart->sameLayout(grid)) compiled = warmStart->model;
+                if (!compiled) compiled = MDPModel::compile(grid, exitPos, options.maxGold);
+                solution->model = compiled;
+                solution->gamma = options.gamma;
+                solution->theta = options.theta;
+                solution->epsilon = options.epsilon;
+                solution->telemetry.warmStarted = warmStart != nullptr;
+
+                if (precision == Precision::Float) {
+                    initialize<float>(warmStart.get());
+                    valueIteration<float>(*compiled);
+                }
+                else {
+                    initialize<double>(warmStart.get());
+                    valueIteration<double>(*compiled);
+                }
+
+                solved = solution;
+                solution.reset();
+                result.cancelled = progress && progress->isCancelled();
+                if (!result.cancelled && options.useCache) cache.insert(solved);
+            }
+
             result.path = extractPath();
 
-            for (int x = 0; x < GRID_SIZE; x++) {
-                for (int y = 0; y < GRID_SIZE; y++) {
-                    if (std::abs(V[x][y][clampGold(startGold)]) > 0.1) {
+            int g0 = clampGold(startGold);
+            for (int x = 0; x < grid.width; x++) {
+                for (int y = 0; y < grid.height; y++) {
+                    if (std::abs(solved->value(solved->index(x, y, g0))) > 0.1) {
                         result.exploredNodes.push_back({ x, y });
                     }
                 }
             }
-            result.expectedValue = V[startX][startY][clampGold(startGold)];
+            result.expectedValue = solved->value(solved->index(startX, startY, g0));
             result.solutionFound = !result.path.empty() && result.path.back() == exitPos;
+            result.precision = solved->precision;
+            result.memoryBytes = solved->storage.size();
+            result.telemetry = solved->telemetry;
             return result;
         }
+
+        // Converged V and policy behind the last solve(), shared with the cache.
+        std::shared_ptr<const MDPSolution> getSolution() const { return solved; }
     };
 }
 
@@ -222,6 +611,18 @@ namespace DungeonAlgorithms {
         return x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE;
     }
 
+    // Per-cell scratch sized to the grid at runtime, indexed like grid[x][y].
+    template <typename T>
+    struct CellArray {
+        int height;
+        std::vector<T> data;
+
+        CellArray(const GridView& grid, const T& init) : height(grid.height), data(grid.cellCount(), init) {}
+
+        T* operator[](int x) { return data.data() + (size_t)x * height; }
+        const T* operator[](int x) const { return data.data() + (size_t)x * height; }
+    };
+
     
     inline int getMoveCost(int cellType) {
         // 0:Empty, 1:Player, 2:Reward, 3:Bandit, 4:Mine, 5:Exit
@@ -231,7 +632,7 @@ namespace DungeonAlgorithms {
     }
 
     inline std::vector<std::pair<int, int>> reconstructPath(
-        const std::pair<int, int> parent[GRID_SIZE][GRID_SIZE],
+        const CellArray<std::pair<int, int>>& parent,
         const std::pair<int, int>& start,
         const std::pair<int, int>& goal) {
 
@@ -251,17 +652,13 @@ namespace DungeonAlgorithms {
     }
 
     // BFS
-    inline SearchResult bfsSearch(const int grid[GRID_SIZE][GRID_SIZE],
-        std::pair<int, int> start, std::pair<int, int> goal) {
+    inline SearchResult bfsSearch(const GridView& grid,
+        std::pair<int, int> start, std::pair<int, int> goal, SearchProgress* progress = nullptr) {
 
         SearchResult result;
         std::queue<std::pair<int, int>> q;
-        bool visited[GRID_SIZE][GRID_SIZE] = { false };
-        std::pair<int, int> parent[GRID_SIZE][GRID_SIZE];
-
-        
-        for (int i = 0; i < GRID_SIZE; ++i)
-            for (int j = 0; j < GRID_SIZE; ++j) parent[i][j] = { -1, -1 };
+        CellArray<std::uint8_t> visited(grid, 0);
+        CellArray<std::pair<int, int>> parent(grid, { -1, -1 });
 
         q.push(start);
         visited[start.first][start.second] = true;
@@ -272,6 +669,7 @@ namespace DungeonAlgorithms {
         while (!q.empty()) {
             auto current = q.front();
             q.pop();
+            if (progress && progress->expand()) return result;
 
             if (current == goal) {
                 result.path = reconstructPath(parent, start, goal);
@@ -282,7 +680,7 @@ namespace DungeonAlgorithms {
                 int nx = current.first + d[0];
                 int ny = current.second + d[1];
 
-                if (isValid(nx, ny) && !visited[nx][ny]) {
+                if (grid.contains(nx, ny) && !visited[nx][ny]) {
                     visited[nx][ny] = true;
                     parent[nx][ny] = current;
                     result.exploredNodes.push_back({ nx, ny });
@@ -294,16 +692,13 @@ namespace DungeonAlgorithms {
     }
 
     // DFS
-    inline SearchResult dfsSearch(const int grid[GRID_SIZE][GRID_SIZE],
-        std::pair<int, int> start, std::pair<int, int> goal) {
+    inline SearchResult dfsSearch(const GridView& grid,
+        std::pair<int, int> start, std::pair<int, int> goal, SearchProgress* progress = nullptr) {
 
         SearchResult result;
         std::stack<std::pair<int, int>> s;
-        bool visited[GRID_SIZE][GRID_SIZE] = { false };
-        std::pair<int, int> parent[GRID_SIZE][GRID_SIZE];
-
-        for (int i = 0; i < GRID_SIZE; ++i)
-            for (int j = 0; j < GRID_SIZE; ++j) parent[i][j] = { -1, -1 };
+        CellArray<std::uint8_t> visited(grid, 0);
+        CellArray<std::pair<int, int>> parent(grid, { -1, -1 });
 
         s.push(start);
         visited[start.first][start.second] = true;
@@ -314,6 +709,7 @@ namespace DungeonAlgorithms {
         while (!s.empty()) {
             auto current = s.top();
             s.pop();
+            if (progress && progress->expand()) return result;
 
             if (current == goal) {
                 result.path = reconstructPath(parent, start, goal);
@@ -325,7 +721,7 @@ namespace DungeonAlgorithms {
                 int nx = current.first + dirs[i][0];
                 int ny = current.second + dirs[i][1];
 
-                if (isValid(nx, ny) && !visited[nx][ny]) {
+                if (grid.contains(nx, ny) && !visited[nx][ny]) {
                     visited[nx][ny] = true;
                     parent[nx][ny] = current;
                     result.exploredNodes.push_back({ nx, ny });
@@ -337,8 +733,8 @@ namespace DungeonAlgorithms {
     }
 
     // A*
-    inline SearchResult aStarSearch(const int grid[GRID_SIZE][GRID_SIZE],
-        std::pair<int, int> start, std::pair<int, int> goal) {
+    inline SearchResult aStarSearch(const GridView& grid,
+        std::pair<int, int> start, std::pair<int, int> goal, SearchProgress* progress = nullptr) {
 
         SearchResult result;
         struct Node {
@@ -348,16 +744,9 @@ namespace DungeonAlgorithms {
         };
 
         std::priority_queue<Node, std::vector<Node>, std::greater<Node>> pq;
-        int gScore[GRID_SIZE][GRID_SIZE];
-        std::pair<int, int> parent[GRID_SIZE][GRID_SIZE];
-        bool visitedVis[GRID_SIZE][GRID_SIZE] = { false }; 
-
-        for (int i = 0; i < GRID_SIZE; ++i) {
-            for (int j = 0; j < GRID_SIZE; ++j) {
-                gScore[i][j] = INT_MAX;
-                parent[i][j] = { -1, -1 };
-            }
-        }
+        CellArray<int> gScore(grid, INT_MAX);
+        CellArray<std::pair<int, int>> parent(grid, { -1, -1 });
+        CellArray<std::uint8_t> visitedVis(grid, 0);
 
         auto heuristic = [&](int x, int y) {
             return std::abs(x - goal.first) + std::abs(y - goal.second);
@@ -373,6 +762,7 @@ namespace DungeonAlgorithms {
         while (!pq.empty()) {
             auto current = pq.top().pos;
             pq.pop();
+            if (progress && progress->expand()) return result;
 
             if (current == goal) {
                 result.path = reconstructPath(parent, start, goal);
@@ -383,8 +773,8 @@ namespace DungeonAlgorithms {
                 int nx = current.first + d[0];
                 int ny = current.second + d[1];
 
-                if (isValid(nx, ny)) {
-                    int newG = gScore[current.first][current.second] + getMoveCost(grid[nx][ny]);
+                if (grid.contains(nx, ny)) {
+                    int newG = gScore[current.first][current.second] + getMoveCost(grid.at(nx, ny));
 
                     if (newG < gScore[nx][ny]) {
                         gScore[nx][ny] = newG;
@@ -404,8 +794,8 @@ namespace DungeonAlgorithms {
     }
 
     // DIJKSTRA
-    inline SearchResult dijkstraSearch(const int grid[GRID_SIZE][GRID_SIZE],
-        std::pair<int, int> start, std::pair<int, int> goal) {
+    inline SearchResult dijkstraSearch(const GridView& grid,
+        std::pair<int, int> start, std::pair<int, int> goal, SearchProgress* progress = nullptr) {
 
         
         SearchResult result;
@@ -416,16 +806,9 @@ namespace DungeonAlgorithms {
         };
 
         std::priority_queue<Node, std::vector<Node>, std::greater<Node>> pq;
-        int dist[GRID_SIZE][GRID_SIZE];
-        std::pair<int, int> parent[GRID_SIZE][GRID_SIZE];
-        bool visitedVis[GRID_SIZE][GRID_SIZE] = { false };
-
-        for (int i = 0; i < GRID_SIZE; ++i) {
-            for (int j = 0; j < GRID_SIZE; ++j) {
-                dist[i][j] = INT_MAX;
-                parent[i][j] = { -1, -1 };
-            }
-        }
+        CellArray<int> dist(grid, INT_MAX);
+        CellArray<std::pair<int, int>> parent(grid, { -1, -1 });
+        CellArray<std::uint8_t> visitedVis(grid, 0);
 
         dist[start.first][start.second] = 0;
         pq.push({ start, 0 });
@@ -440,6 +823,7 @@ namespace DungeonAlgorithms {
             pq.pop();
 
             if (d > dist[current.first][current.second]) continue;
+            if (progress && progress->expand()) return result;
             if (current == goal) {
                 result.path = reconstructPath(parent, start, goal);
                 return result;
@@ -449,8 +833,8 @@ namespace DungeonAlgorithms {
                 int nx = current.first + dir[0];
                 int ny = current.second + dir[1];
 
-                if (isValid(nx, ny)) {
-                    int newDist = dist[current.first][current.second] + getMoveCost(grid[nx][ny]);
+                if (grid.contains(nx, ny)) {
+                    int newDist = dist[current.first][current.second] + getMoveCost(grid.at(nx, ny));
                     if (newDist < dist[nx][ny]) {
                         dist[nx][ny] = newDist;
                         parent[nx][ny] = current;
@@ -468,8 +852,8 @@ namespace DungeonAlgorithms {
     }
 
 	// GREEDY BEST-FIRST SEARCH
-    inline SearchResult greedySearch(const int grid[GRID_SIZE][GRID_SIZE],
-        std::pair<int, int> start, std::pair<int, int> goal) {
+    inline SearchResult greedySearch(const GridView& grid,
+        std::pair<int, int> start, std::pair<int, int> goal, SearchProgress* progress = nullptr) {
 
         SearchResult result;
         auto heuristic = [&](int x, int y) { return std::abs(x - goal.first) + std::abs(y - goal.second); };
@@ -481,11 +865,8 @@ namespace DungeonAlgorithms {
         };
 
         std::priority_queue<Node, std::vector<Node>, std::greater<Node>> pq;
-        bool visited[GRID_SIZE][GRID_SIZE] = { false };
-        std::pair<int, int> parent[GRID_SIZE][GRID_SIZE];
-
-        for (int i = 0; i < GRID_SIZE; ++i)
-            for (int j = 0; j < GRID_SIZE; ++j) parent[i][j] = { -1, -1 };
+        CellArray<std::uint8_t> visited(grid, 0);
+        CellArray<std::pair<int, int>> parent(grid, { -1, -1 });
 
         pq.push({ start, heuristic(start.first, start.second) });
         visited[start.first][start.second] = true;
@@ -496,6 +877,7 @@ namespace DungeonAlgorithms {
         while (!pq.empty()) {
             auto current = pq.top().pos;
             pq.pop();
+            if (progress && progress->expand()) return result;
 
             if (current == goal) {
                 result.path = reconstructPath(parent, start, goal);
@@ -506,7 +888,7 @@ namespace DungeonAlgorithms {
                 int nx = current.first + dir[0];
                 int ny = current.second + dir[1];
 
-                if (isValid(nx, ny) && !visited[nx][ny]) {
+                if (grid.contains(nx, ny) && !visited[nx][ny]) {
                     visited[nx][ny] = true;
                     parent[nx][ny] = current;
                     result.exploredNodes.push_back({ nx, ny });
@@ -518,15 +900,49 @@ namespace DungeonAlgorithms {
     }
 
     // MDP
-    inline SearchResult mdpSearch(const int grid[GRID_SIZE][GRID_SIZE],
-        std::pair<int, int> start, std::pair<int, int> goal, int currentGold = 0) {
+    inline SearchResult mdpSearch(const GridView& grid,
+        std::pair<int, int> start, std::pair<int, int> goal, int currentGold = 0,
+        DungeonMDP::MDPResult* details = nullptr, SearchProgress* progress = nullptr) {
 
         DungeonMDP::MDPSolver solver(grid, start, goal, currentGold);
+        solver.setProgress(progress);
         DungeonMDP::MDPResult mdpRes = solver.solve();
+        if (details) *details = mdpRes;
 
         SearchResult result;
         result.path = mdpRes.path;
         result.exploredNodes = mdpRes.exploredNodes;
         return result;
     }
+
+    // Fixed-size overloads for GameState's int grid[GRID_SIZE][GRID_SIZE].
+    inline SearchResult bfsSearch(const int grid[GRID_SIZE][GRID_SIZE], std::pair<int, int> start, std::pair<int, int> goal,
+        SearchProgress* progress = nullptr) {
+        return bfsSearch(GridView(grid), start, goal, progress);
+    }
+
+    inline SearchResult dfsSearch(const int grid[GRID_SIZE][GRID_SIZE], std::pair<int, int> start, std::pair<int, int> goal,
+        SearchProgress* progress = nullptr) {
+        return dfsSearch(GridView(grid), start, goal, progress);
+    }
+
+    inline SearchResult aStarSearch(const int grid[GRID_SIZE][GRID_SIZE], std::pair<int, int> start, std::pair<int, int> goal,
+        SearchProgress* progress = nullptr) {
+        return aStarSearch(GridView(grid), start, goal, progress);
+    }
+
+    inline SearchResult dijkstraSearch(const int grid[GRID_SIZE][GRID_SIZE], std::pair<int, int> start, std::pair<int, int> goal,
+        SearchProgress* progress = nullptr) {
+        return dijkstraSearch(GridView(grid), start, goal, progress);
+    }
+
+    inline SearchResult greedySearch(const int grid[GRID_SIZE][GRID_SIZE], std::pair<int, int> start, std::pair<int, int> goal,
+        SearchProgress* progress = nullptr) {
+        return greedySearch(GridView(grid), start, goal, progress);
+    }
+
+    inline SearchResult mdpSearch(const int grid[GRID_SIZE][GRID_SIZE], std::pair<int, int> start, std::pair<int, int> goal,
+        int currentGold = 0, DungeonMDP::MDPResult* details = nullptr, SearchProgress* progress = nullptr) {
+        return mdpSearch(GridView(grid), start, goal, currentGold, details, progress);
+    }
 }
\ No newline at end of file
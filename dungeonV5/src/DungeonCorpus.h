@@ -0,0 +1,285 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <tuple>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "GridView.h"
+#include "DungeonGenerator.h"
+#include "GameState.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Binary corpus of dungeon layouts for reproducible benchmarks.
+//
+//   Header   64 bytes (magic, version, grid size, record count/size, section offsets,
+//            byte-order marker)
+//   Records  fixed width: start/exit as uint16, then width*height tile bytes in
+//            GridView order (x * height + y), padded to 8 bytes
+//   Index    (layoutHash, record number) pairs sorted by hash
+//
+// Integers are in the writer's native byte order and are mapped back unchanged, so a
+// file written on a host of the other endianness is rejected by its byte-order marker
+// rather than misread. The reader maps the file and hands out GridViews that point
+// straight into the mapping, so opening a corpus does not parse or copy the records.
+namespace DungeonCorpus {
+
+    constexpr char MAGIC[8] = { 'D', 'G', 'N', 'C', 'O', 'R', 'P', 'S' };
+    constexpr std::uint32_t VERSION = 1;
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    constexpr std::uint32_t SWAPPED_BYTE_ORDER_MARK = 0x04030201;
+    constexpr size_t RECORD_HEADER_BYTES = 8;
+
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t recordBytes;
+        std::uint64_t count;
+        std::uint64_t recordsOffset;
+        std::uint64_t indexOffset;
+        std::uint32_t byteOrder;
+        std::uint8_t reserved[12];
+    };
+    static_assert(sizeof(FileHeader) == 64, "corpus header is 64 bytes on disk");
+
+    struct IndexEntry {
+        std::uint64_t hash;
+        std::uint64_t record;
+    };
+
+    inline std::uint32_t recordBytes(int width, int height) {
+        return (std::uint32_t)((RECORD_HEADER_BYTES + (size_t)width * height + 7) & ~size_t(7));
+    }
+
+    // Index key of a record. For GRID_SIZE corpora it is GameState::layoutHash, so find()
+    // takes InitialState::layoutHash or a journal's layout hash directly. GameState cannot
+    // hold other sizes; those fall back to FNV-1a over size, start, exit and tiles.
+    inline std::uint64_t layoutHash(int width, int height, int sx, int sy, int ex, int ey, const std::uint8_t* tiles) {
+        if (width == GameState::GRID_SIZE && height == GameState::GRID_SIZE)
+            return GameState::layoutHash(tiles, sx, sy);
+        std::uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](std::uint32_t v) {
+            for (int i = 0; i < 4; i++) { h ^= (v >> (8 * i)) & 0xFF; h *= 1099511628211ull; }
+        };
+        mix(width); mix(height); mix(sx); mix(sy); mix(ex); mix(ey);
+        for (size_t i = 0; i < (size_t)width * height; i++) { h ^= tiles[i]; h *= 1099511628211ull; }
+        return h;
+    }
+
+    class CorpusWriter {
+    private:
+        FILE* file = nullptr;
+        FileHeader header;
+        std::vector<IndexEntry> index;
+        std::vector<std::uint8_t> buffer;
+
+    public:
+        CorpusWriter() = default;
+        CorpusWriter(const CorpusWriter&) = delete;
+        CorpusWriter& operator=(const CorpusWriter&) = delete;
+        ~CorpusWriter() { finish(); }
+
+        bool open(const std::string& path, int width, int height) {
+            finish();
+            file = fopen(path.c_str(), "wb");
+            if (!file) return false;
+
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.byteOrder = BYTE_ORDER_MARK;
+            header.width = (std::uint32_t)width;
+            header.height = (std::uint32_t)height;
+            header.recordBytes = recordBytes(width, height);
+            header.recordsOffset = sizeof(FileHeader);
+            index.clear();
+            buffer.assign(header.recordBytes, 0);
+            return fwrite(&header, sizeof(header), 1, file) == 1;
+        }
+
+        bool append(const DungeonGen::Dungeon& d) {
+            if (!file || d.width != (int)header.width || d.height != (int)header.height) return false;
+            std::fill(buffer.begin(), buffer.end(), 0);
+            const std::uint16_t pos[4] = { (std::uint16_t)d.startX, (std::uint16_t)d.startY,
+                                           (std::uint16_t)d.exitX, (std::uint16_t)d.exitY };
+            memcpy(buffer.data(), pos, sizeof(pos));
+            memcpy(buffer.data() + RECORD_HEADER_BYTES, d.tiles.data(), d.tiles.size());
+
+            index.push_back({ layoutHash(d.width, d.height, d.startX, d.startY, d.exitX, d.exitY, d.tiles.data()),
+                              header.count });
+            header.count++;
+            return fwrite(buffer.data(), buffer.size(), 1, file) == 1;
+        }
+
+        bool append(const GameState::InitialState& s) {
+            DungeonGen::Dungeon d;
+            d.width = d.height = GameState::GRID_SIZE;
+            d.startX = s.playerStartX; d.startY = s.playerStartY;
+            d.exitX = s.exitX; d.exitY = s.exitY;
+            d.tiles.resize((size_t)d.width * d.height);
+            for (int x = 0; x < d.width; x++)
+                for (int y = 0; y < d.height; y++)
+                    d.tiles[(size_t)x * d.height + y] = (std::uint8_t)s.actualGrid[x][y];
+            return append(d);
+        }
+
+        // Writes the index and the final header. Called by the destructor too.
+        bool finish() {
+            if (!file) return true;
+            std::sort(index.begin(), index.end(),
+                [](const IndexEntry& a, const IndexEntry& b) { return a.hash < b.hash || (a.hash == b.hash && a.record < b.record); });
+            header.indexOffset = header.recordsOffset + header.count * header.recordBytes;
+            bool ok = index.empty() || fwrite(index.data(), sizeof(IndexEntry), index.size(), file) == index.size();
+            ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+            ok = (fclose(file) == 0) && ok;
+            file = nullptr;
+            return ok;
+        }
+    };
+
+    class CorpusReader {
+    private:
+        const std::uint8_t* base = nullptr;
+        size_t bytes = 0;
+        const FileHeader* header = nullptr;
+        const IndexEntry* index = nullptr;
+        std::string error;
+#ifdef _WIN32
+        HANDLE fileHandle = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+
+        bool fail(const char* message) {
+            error = message;
+            close();
+            return false;
+        }
+
+        const std::uint8_t* record(size_t i) const {
+            return base + header->recordsOffset + i * header->recordBytes;
+        }
+
+        const std::uint16_t* positions(size_t i) const {
+            return reinterpret_cast<const std::uint16_t*>(record(i));
+        }
+
+    public:
+        CorpusReader() = default;
+        CorpusReader(const CorpusReader&) = delete;
+        CorpusReader& operator=(const CorpusReader&) = delete;
+        ~CorpusReader() { close(); }
+
+        bool open(const std::string& path) {
+            close();
+#ifdef _WIN32
+            fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (fileHandle == INVALID_HANDLE_VALUE) return fail("cannot open corpus");
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(fileHandle, &size)) return fail("cannot stat corpus");
+            bytes = (size_t)size.QuadPart;
+            if (bytes < sizeof(FileHeader)) return fail("corpus too small");
+            mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) return fail("cannot map corpus");
+            base = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!base) return fail("cannot map corpus");
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return fail("cannot open corpus");
+            struct stat st;
+            if (fstat(fd, &st) != 0) { ::close(fd); return fail("cannot stat corpus"); }
+            bytes = (size_t)st.st_size;
+            if (bytes < sizeof(FileHeader)) { ::close(fd); return fail("corpus too small"); }
+            void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) { base = nullptr; return fail("cannot map corpus"); }
+            base = static_cast<const std::uint8_t*>(p);
+#endif
+            header = reinterpret_cast<const FileHeader*>(base);
+            if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) return fail("not a dungeon corpus");
+            if (header->byteOrder == SWAPPED_BYTE_ORDER_MARK) return fail("corpus written with the other byte order");
+            if (header->version != VERSION || header->byteOrder != BYTE_ORDER_MARK) return fail("unsupported corpus version");
+            // Start and exit are stored as uint16, which also keeps width * height in range.
+            if (header->width == 0 || header->height == 0 || header->width > 0xFFFF || header->height > 0xFFFF ||
+                header->recordBytes != ((RECORD_HEADER_BYTES + (std::uint64_t)header->width * header->height + 7) & ~std::uint64_t(7)))
+                return fail("corrupt record size");
+            // Sizes are checked by division so a crafted count cannot wrap past the file size.
+            const std::uint64_t fileBytes = bytes;
+            if (header->recordsOffset < sizeof(FileHeader) || header->recordsOffset % 8 != 0 ||
+                header->recordsOffset > fileBytes) return fail("corrupt records offset");
+            if (header->count > (fileBytes - header->recordsOffset) / header->recordBytes) return fail("corpus truncated");
+            if (header->indexOffset != header->recordsOffset + header->count * header->recordBytes ||
+                header->count > (fileBytes - header->indexOffset) / sizeof(IndexEntry)) return fail("corpus truncated");
+            index = reinterpret_cast<const IndexEntry*>(base + header->indexOffset);
+            error.clear();
+            return true;
+        }
+
+        void close() {
+#ifdef _WIN32
+            if (base) UnmapViewOfFile(base);
+            if (mapping) CloseHandle(mapping);
+            if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+            mapping = nullptr;
+            fileHandle = INVALID_HANDLE_VALUE;
+#else
+            if (base) munmap(const_cast<std::uint8_t*>(base), bytes);
+#endif
+            base = nullptr;
+            header = nullptr;
+            index = nullptr;
+            bytes = 0;
+        }
+
+        bool isOpen() const { return base != nullptr; }
+        const std::string& getError() const { return error; }
+        size_t size() const { return header ? (size_t)header->count : 0; }
+        int width() const { return header ? (int)header->width : 0; }
+        int height() const { return header ? (int)header->height : 0; }
+
+        // Zero-copy view of record i, ready for DungeonAlgorithms and MDPSolver.
+        GridView grid(size_t i) const {
+            return GridView(record(i) + RECORD_HEADER_BYTES, width(), height());
+        }
+        std::pair<int, int> start(size_t i) const { return { positions(i)[0], positions(i)[1] }; }
+        std::pair<int, int> exit(size_t i) const { return { positions(i)[2], positions(i)[3] }; }
+
+        std::uint64_t hash(size_t i) const {
+            auto s = start(i), e = exit(i);
+            return layoutHash(width(), height(), s.first, s.second, e.first, e.second, record(i) + RECORD_HEADER_BYTES);
+        }
+
+        // First record whose layoutHash (see above) equals this one, or -1.
+        long long find(std::uint64_t layoutHash) const {
+            const IndexEntry* end = index + size();
+            const IndexEntry* it = std::lower_bound(index, end, layoutHash,
+                [](const IndexEntry& e, std::uint64_t h) { return e.hash < h; });
+            return (it != end && it->hash == layoutHash && it->record < size()) ? (long long)it->record : -1;
+        }
+
+        // Copies record i into a GameState layout; only for GRID_SIZE corpora.
+        bool toInitialState(size_t i, GameState::InitialState& s) const {
+            if (width() != GameState::GRID_SIZE || height() != GameState::GRID_SIZE) return false;
+            DungeonGen::Dungeon d;
+            d.width = width(); d.height = height();
+            std::tie(d.startX, d.startY) = start(i);
+            std::tie(d.exitX, d.exitY) = exit(i);
+            const std::uint8_t* tiles = record(i) + RECORD_HEADER_BYTES;
+            d.tiles.assign(tiles, tiles + (size_t)d.width * d.height);
+            return GameState::initialStateFromDungeon(d, s);
+        }
+    };
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+#include "GridView.h"
+
+// Dungeon generation without rejection sampling. Tiles are drawn from a list of free
+// interior cells with a partial Fisher-Yates shuffle, so placing k tiles costs k draws
+// and never fails. Each candidate is then checked for winnability, and regenerated
+// if needed. Grid size and tile counts (or densities) are configurable; the
+// 10x10 / 5-5-5 defaults match GameState.
+namespace DungeonGen {
+
+    // Same cell codes as GameState.
+    enum Tile : std::uint8_t { EMPTY = 0, PLAYER = 1, REWARD = 2, BANDIT = 3, MINE = 4, EXIT = 5 };
+
+    struct GeneratorConfig {
+        int width = 10;
+        int height = 10;
+        int rewards = 5, bandits = 5, mines = 5;
+        // When > 0 these override the counts as a fraction of the interior cells.
+        double rewardDensity = 0.0, banditDensity = 0.0, mineDensity = 0.0;
+        int goldToWin = 20;
+        int goldPerReward = 10;
+        bool requireWinnable = true;
+        int maxAttempts = 64;
+    };
+
+    // Column-major tiles (x * height + y) using the GameState cell codes.
+    struct Dungeon {
+        int width = 0, height = 0;
+        int startX = 0, startY = 0;
+        int exitX = 0, exitY = 0;
+        std::vector<std::uint8_t> tiles;
+
+        GridView view() const { return GridView(tiles.data(), width, height); }
+        int at(int x, int y) const { return tiles[(size_t)x * height + y]; }
+    };
+
+    // Unbiased draw in [0, n) from raw engine output (Lemire). Unlike
+    // std::uniform_int_distribution, the result is the same on every standard library.
+    inline std::uint32_t bounded(std::mt19937& rng, std::uint32_t n) {
+        std::uint64_t m = (std::uint64_t)(std::uint32_t)rng() * n;
+        std::uint32_t low = (std::uint32_t)m;
+        if (low < n) {
+            std::uint32_t threshold = (std::uint32_t)(-n) % n;
+            while (low < threshold) {
+                m = (std::uint64_t)(std::uint32_t)rng() * n;
+                low = (std::uint32_t)m;
+            }
+        }
+        return (std::uint32_t)(m >> 32);
+    }
+
+    class DungeonGenerator {
+    private:
+        GeneratorConfig config;
+        int rewardCount = 0, banditCount = 0, mineCount = 0;
+
+        // Interior cells. The partial Fisher-Yates swaps are undone after each attempt
+        // (O(k)), so every call starts from the same order and a seed always yields the
+        // same dungeon, whatever was generated before on this generator.
+        std::vector<std::uint32_t> freeCells;
+        std::vector<std::uint32_t> swaps;
+
+        // Flood-fill scratch, stamped per call instead of cleared.
+        std::vector<std::uint32_t> seen;
+        std::vector<std::uint32_t> queue;
+        std::uint32_t stamp = 0;
+
+        int countFor(double density, int count) const {
+            if (density <= 0.0) return count;
+            return (int)(density * (double)freeCells.size() + 0.5);
+        }
+
+    public:
+        explicit DungeonGenerator(const GeneratorConfig& cfg = GeneratorConfig()) : config(cfg) {
+            config.width = std::max(3, config.width);
+            config.height = std::max(1, config.height);
+            for (int x = 1; x < config.width - 1; x++)
+                for (int y = 0; y < config.height; y++)
+                    freeCells.push_back((std::uint32_t)((size_t)x * config.height + y));
+
+            rewardCount = countFor(config.rewardDensity, config.rewards);
+            banditCount = countFor(config.banditDensity, config.bandits);
+            mineCount = countFor(config.mineDensity, config.mines);
+            int n = (int)freeCells.size();
+            rewardCount = std::max(0, std::min(rewardCount, n));
+            banditCount = std::max(0, std::min(banditCount, n - rewardCount));
+            mineCount = std::max(0, std::min(mineCount, n - rewardCount - banditCount));
+            seen.assign((size_t)config.width * config.height, 0);
+            queue.reserve(seen.size());
+            swaps.reserve(rewardCount + banditCount + mineCount);
+        }
+
+        const GeneratorConfig& getConfig() const { return config; }
+
+        // Fills `out` (reusing its buffers). Returns false only when requireWinnable is
+        // set and maxAttempts candidates all failed; `out` then holds the last candidate.
+        bool generate(std::mt19937& rng, Dungeon& out) {
+            const int W = config.width, H = config.height;
+            const int k = rewardCount + banditCount + mineCount;
+            const std::uint32_t n = (std::uint32_t)freeCells.size();
+
+            for (int attempt = 0; attempt < std::max(1, config.maxAttempts); attempt++) {
+                out.width = W;
+                out.height = H;
+                out.tiles.assign((size_t)W * H, EMPTY);
+
+                out.startX = 0;
+                out.startY = (int)bounded(rng, (std::uint32_t)H);
+                out.exitX = W - 1;
+                out.exitY = (int)bounded(rng, (std::uint32_t)H);
+                out.tiles[(size_t)out.startX * H + out.startY] = PLAYER;
+                out.tiles[(size_t)out.exitX * H + out.exitY] = EXIT;
+
+                swaps.clear();
+                for (int i = 0; i < k; i++) {
+                    std::uint32_t j = i + bounded(rng, n - i);
+                    std::swap(freeCells[i], freeCells[j]);
+                    swaps.push_back(j);
+                    int type = i < rewardCount ? REWARD
+                        : (i < rewardCount + banditCount ? BANDIT : MINE);
+                    out.tiles[freeCells[i]] = (std::uint8_t)type;
+                }
+                for (int i = k - 1; i >= 0; i--) std::swap(freeCells[i], freeCells[swaps[i]]);
+
+                if (!config.requireWinnable || isWinnable(out)) return true;
+            }
+            return false;
+        }
+
+        // Sufficient check: the player can collect goldToWin from rewards reachable
+        // without touching a bandit, a mine or the exit, and then step onto the exit.
+        // Such a dungeon is winnable whatever the mine questions' answers are.
+        bool isWinnable(const Dungeon& d) {
+            const int H = d.height;
+            if (seen.size() != d.tiles.size()) seen.assign(d.tiles.size(), 0);
+            if (++stamp == 0) { std::fill(seen.begin(), seen.end(), 0); stamp = 1; }
+
+            queue.clear();
+            std::uint32_t start = (std::uint32_t)((size_t)d.startX * H + d.startY);
+            queue.push_back(start);
+            seen[start] = stamp;
+
+            int gold = 0;
+            bool touchesExit = false;
+            for (size_t head = 0; head < queue.size(); head++) {
+                std::uint32_t c = queue[head];
+                int x = (int)(c / H), y = (int)(c % H);
+                if (d.tiles[c] == REWARD) gold += config.goldPerReward;
+
+                const int dirs[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+                for (auto& dir : dirs) {
+                    int nx = x + dir[0], ny = y + dir[1];
+                    if (nx < 0 || nx >= d.width || ny < 0 || ny >= H) continue;
+                    std::uint32_t nc = (std::uint32_t)((size_t)nx * H + ny);
+                    int cell = d.tiles[nc];
+                    if (cell == EXIT) { touchesExit = true; continue; }
+                    if (cell == BANDIT || cell == MINE || seen[nc] == stamp) continue;
+                    seen[nc] = stamp;
+                    queue.push_back(nc);
+                }
+            }
+            return touchesExit && gold >= config.goldToWin;
+        }
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include "DungeonGenerator.h"
+
+// Camera and level-of-detail data for viewing dungeons far larger than the screen.
+// Nothing here depends on the GUI; the canvas turns visible cells or blocks into shapes.
+namespace DungeonView {
+
+    // Maps dungeon cells to view pixels: cell (x, y) starts at
+    // ((x - originX) * cellPx, (y - originY) * cellPx) relative to the view's top-left.
+    struct Camera {
+        double cellPx = 1.0;
+        double originX = 0.0, originY = 0.0;
+        double minCellPx = 0.01, maxCellPx = 64.0;
+
+        // Whole dungeon visible and centred; zooming out further is not allowed.
+        void fit(int width, int height, double viewW, double viewH) {
+            cellPx = std::min(viewW / width, viewH / height);
+            minCellPx = cellPx;
+            originX = (width - viewW / cellPx) * 0.5;
+            originY = (height - viewH / cellPx) * 0.5;
+        }
+
+        // Zooms by factor keeping the cell under (px, py) in place.
+        void zoomAt(double factor, double px, double py) {
+            double wx = originX + px / cellPx, wy = originY + py / cellPx;
+            cellPx = std::max(minCellPx, std::min(maxCellPx, cellPx * factor));
+            originX = wx - px / cellPx;
+            originY = wy - py / cellPx;
+        }
+
+        void pan(double dxPx, double dyPx) {
+            originX -= dxPx / cellPx;
+            originY -= dyPx / cellPx;
+        }
+
+        // Half-open range of cells that intersect a viewW x viewH view.
+        void visibleCells(int width, int height, double viewW, double viewH, int& x0, int& y0, int& x1, int& y1) const {
+            x0 = std::max(0, (int)std::floor(originX));
+            y0 = std::max(0, (int)std::floor(originY));
+            x1 = std::min(width, (int)std::ceil(originX + viewW / cellPx));
+            y1 = std::min(height, (int)std::ceil(originY + viewH / cellPx));
+        }
+    };
+
+    // Breaks ties when a block is reduced to one tile.
+    inline int tileRank(int tile) {
+        static const int rank[6] = { 0, 5, 1, 2, 3, 6 };   // empty, player, reward, bandit, mine, exit
+        return tile >= 0 && tile < 6 ? rank[tile] : 0;
+    }
+
+    // Most common non-empty tile among up to four children (empty if all are empty).
+    inline int combineTiles(const int* t, int n) {
+        int best = 0, bestCount = 0;
+        for (int i = 0; i < n; i++) {
+            if (t[i] == 0) continue;
+            int count = 0;
+            for (int j = 0; j < n; j++) count += t[j] == t[i];
+            if (count > bestCount || (count == bestCount && tileRank(t[i]) > tileRank(best))) { best = t[i]; bestCount = count; }
+        }
+        return best;
+    }
+
+    // Mip chain over a dungeon's tiles. Level k has one byte per 2^k x 2^k block,
+    // holding the prevailing non-empty tile of its four children, so far-out views
+    // keep the local mix of rewards, bandits and mines. Level 0 is the dungeon itself.
+    // Costs about a third of the tile array and is built once per dungeon.
+    class TilePyramid {
+    private:
+        struct Level {
+            int width = 0, height = 0;
+            std::vector<std::uint8_t> tiles;    // column-major like the dungeon
+        };
+        const DungeonGen::Dungeon* base = nullptr;
+        std::vector<Level> levels;              // levels[k - 1] is level k
+
+    public:
+        void build(const DungeonGen::Dungeon& d) {
+            base = &d;
+            levels.clear();
+            int w = d.width, h = d.height;
+            while (w > 1 || h > 1) {
+                Level next;
+                next.width = (w + 1) / 2;
+                next.height = (h + 1) / 2;
+                next.tiles.assign((size_t)next.width * next.height, 0);
+                int k = (int)levels.size();
+                auto at = [&](int x, int y) { return k == 0 ? d.at(x, y) : (int)levels[k - 1].tiles[(size_t)x * h + y]; };
+                for (int bx = 0; bx < next.width; bx++) {
+                    for (int by = 0; by < next.height; by++) {
+                        int children[4], n = 0;
+                        for (int x = 2 * bx; x < std::min(w, 2 * bx + 2); x++)
+                            for (int y = 2 * by; y < std::min(h, 2 * by + 2); y++)
+                                children[n++] = at(x, y);
+                        next.tiles[(size_t)bx * next.height + by] = (std::uint8_t)combineTiles(children, n);
+                    }
+                }
+                levels.push_back(std::move(next));
+                w = levels.back().width;
+                h = levels.back().height;
+            }
+        }
+
+        int levelCount() const { return (int)levels.size() + 1; }
+        int width(int level) const { return level == 0 ? base->width : levels[level - 1].width; }
+        int height(int level) const { return level == 0 ? base->height : levels[level - 1].height; }
+
+        int at(int level, int bx, int by) const {
+            if (level == 0) return base->at(bx, by);
+            const Level& l = levels[level - 1];
+            return l.tiles[(size_t)bx * l.height + by];
+        }
+
+        // Coarsest detail that still keeps blocks at least minPx wide on screen.
+        int levelFor(double cellPx, double minPx) const {
+            int level = 0;
+            while (level + 1 < levelCount() && cellPx * (1 << level) < minPx) level++;
+            return level;
+        }
+    };
+}
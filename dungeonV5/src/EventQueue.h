@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded single-producer/single-consumer ring buffer. Storage is inline and
+// fixed, so push and pop never allocate. A full queue rejects the push and counts
+// it, rather than blocking the producer.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    // Producer and consumer indices on separate cache lines.
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    alignas(64) std::atomic<size_t> head{ 0 };
+    std::atomic<std::uint32_t> dropped{ 0 };
+    T items[Capacity];
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side.
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[t & MASK] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    bool pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = items[h & MASK];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pops everything currently queued into f(const T&); returns the count.
+    template <typename F>
+    size_t drain(F&& f) {
+        size_t n = 0;
+        T item;
+        while (pop(item)) { f(item); n++; }
+        return n;
+    }
+
+    // Consumer side: discards queued items.
+    void clear() {
+        head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    std::uint32_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    static constexpr size_t capacity() { return Capacity; }
+};
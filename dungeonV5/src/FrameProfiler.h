@@ -0,0 +1,156 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+
+// Per-frame timing for the canvas. A frame is split into phases; enter() charges the
+// time since the previous call to the phase that was active and switches to the new
+// one. The last WINDOW frames are kept for percentiles and the histogram, and every
+// frame can also be appended to a CSV file. When disabled the canvas skips all calls,
+// apart from the shape and string counters, which are plain increments.
+class FrameProfiler {
+public:
+    enum Phase { PHASE_UPDATE, PHASE_GRID, PHASE_PANEL, PHASE_TABLE, PHASE_HUD, NUM_PHASES };
+    static constexpr int WINDOW = 256;
+    // Histogram bucket upper bounds in milliseconds; the last bucket is open.
+    static constexpr int NUM_BUCKETS = 7;
+    static constexpr double BUCKET_LIMITS[NUM_BUCKETS - 1] = { 1.0, 2.0, 4.0, 8.0, 16.7, 33.3 };
+
+    struct Frame {
+        double phaseMs[NUM_PHASES] = {};
+        double totalMs = 0.0;           // beginFrame to endFrame
+        double intervalMs = 0.0;        // since the previous beginFrame
+        std::uint32_t shapes = 0;
+        std::uint32_t strings = 0;
+    };
+
+    struct Summary {
+        int frames = 0;
+        double fps = 0.0;
+        double p50 = 0.0, p95 = 0.0, p99 = 0.0;     // frame time, milliseconds
+        double meanPhaseMs[NUM_PHASES] = {};
+        std::uint32_t buckets[NUM_BUCKETS] = {};
+        Frame last;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool enabled = false;
+    FILE* dump = nullptr;
+    Frame frames[WINDOW];
+    int count = 0, next = 0;
+    std::uint64_t frameIndex = 0;
+    Frame current;
+    Phase phase = PHASE_UPDATE;
+    Clock::time_point frameStart, mark, previousStart;
+    bool havePrevious = false;
+
+    static double ms(Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+
+    static const char* phaseName(int p) {
+        static const char* names[NUM_PHASES] = { "update", "grid", "panel", "table", "hud" };
+        return names[p];
+    }
+
+public:
+    FrameProfiler() = default;
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+    ~FrameProfiler() { stopDump(); }
+
+    bool isEnabled() const { return enabled; }
+
+    void setEnabled(bool on) {
+        if (on && !enabled) { count = next = 0; havePrevious = false; }
+        enabled = on;
+    }
+
+    // Appends one CSV row per frame to path while the profiler is enabled.
+    bool startDump(const std::string& path) {
+        stopDump();
+        dump = fopen(path.c_str(), "w");
+        if (!dump) return false;
+        fprintf(dump, "frame,interval_ms,total_ms");
+        for (int p = 0; p < NUM_PHASES; p++) fprintf(dump, ",%s_ms", phaseName(p));
+        fprintf(dump, ",shapes,strings\n");
+        return true;
+    }
+
+    void stopDump() {
+        if (dump) fclose(dump);
+        dump = nullptr;
+    }
+
+    bool isDumping() const { return dump != nullptr; }
+
+    void countShapes(std::uint32_t n) { current.shapes += n; }
+    void countStrings(std::uint32_t n) { current.strings += n; }
+
+    void beginFrame() {
+        Clock::time_point now = Clock::now();
+        current = Frame();
+        current.intervalMs = havePrevious ? ms(previousStart, now) : 0.0;
+        previousStart = now;
+        havePrevious = true;
+        frameStart = mark = now;
+        phase = PHASE_UPDATE;
+    }
+
+    void enter(Phase p) {
+        Clock::time_point now = Clock::now();
+        current.phaseMs[phase] += ms(mark, now);
+        mark = now;
+        phase = p;
+    }
+
+    void endFrame() {
+        enter(phase);
+        current.totalMs = ms(frameStart, mark);
+        frames[next] = current;
+        next = (next + 1) % WINDOW;
+        count = std::min(count + 1, WINDOW);
+
+        if (dump) {
+            fprintf(dump, "%llu,%.4f,%.4f", (unsigned long long)frameIndex, current.intervalMs, current.totalMs);
+            for (int p = 0; p < NUM_PHASES; p++) fprintf(dump, ",%.4f", current.phaseMs[p]);
+            fprintf(dump, ",%u,%u\n", current.shapes, current.strings);
+        }
+        frameIndex++;
+    }
+
+    Summary summary() const {
+        Summary s;
+        s.frames = count;
+        if (count == 0) return s;
+        s.last = frames[(next + WINDOW - 1) % WINDOW];
+
+        double times[WINDOW];
+        double intervalSum = 0.0;
+        int intervals = 0;
+        for (int i = 0; i < count; i++) {
+            const Frame& f = frames[i];
+            times[i] = f.totalMs;
+            for (int p = 0; p < NUM_PHASES; p++) s.meanPhaseMs[p] += f.phaseMs[p] / count;
+            if (f.intervalMs > 0.0) { intervalSum += f.intervalMs; intervals++; }
+            int b = 0;
+            while (b < NUM_BUCKETS - 1 && f.totalMs > BUCKET_LIMITS[b]) b++;
+            s.buckets[b]++;
+        }
+        if (intervalSum > 0.0) s.fps = 1000.0 * intervals / intervalSum;
+
+        auto at = [&](double q) {
+            int k = (int)(q * (count - 1));
+            std::nth_element(times, times + k, times + count);
+            return times[k];
+        };
+        s.p50 = at(0.50);
+        s.p95 = at(0.95);
+        s.p99 = at(0.99);
+        return s;
+    }
+};
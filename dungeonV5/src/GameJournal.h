@@ -0,0 +1,251 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include "GameState.h"
+
+// Append-only input journal. Records everything that changes a GameState from the
+// outside: the generation seed, every movePlayer target, every mine answer and the
+// position resets. Since dungeon generation is a pure function of the seed,
+// replaying the journal reproduces a session exactly.
+//
+//   File     "DGNJRNL" + version byte, then records back to back
+//   Record   opcode byte + payload (little-endian); sizes are whole records
+//            NEW_GAME        uint32 seed, uint64 layout hash   (13 bytes)
+//            MOVE            int8 x, int8 y                    (3 bytes)
+//            MINE_ANSWER     uint8 correct                     (2 bytes)
+//            RESET_POSITION  -                                 (1 byte)
+//            REVEAL_ALL      -                                 (1 byte)
+namespace DungeonJournal {
+
+    constexpr char MAGIC[7] = { 'D', 'G', 'N', 'J', 'R', 'N', 'L' };
+    constexpr std::uint8_t VERSION = 1;
+    constexpr size_t HEADER_BYTES = sizeof(MAGIC) + 1;
+
+    enum Op : std::uint8_t {
+        OP_NEW_GAME = 1,
+        OP_MOVE = 2,
+        OP_MINE_ANSWER = 3,
+        OP_RESET_POSITION = 4,
+        OP_REVEAL_ALL = 5
+    };
+
+    inline const char* opName(std::uint8_t op) {
+        switch (op) {
+        case OP_NEW_GAME:       return "new_game";
+        case OP_MOVE:           return "move";
+        case OP_MINE_ANSWER:    return "mine_answer";
+        case OP_RESET_POSITION: return "reset_position";
+        case OP_REVEAL_ALL:     return "reveal_all";
+        }
+        return "unknown";
+    }
+
+    class JournalWriter {
+    private:
+        FILE* file = nullptr;
+        bool autoFlush = true;
+
+        void write(const std::uint8_t* bytes, size_t n) {
+            if (!file) return;
+            fwrite(bytes, 1, n, file);
+            if (autoFlush) fflush(file);
+        }
+
+    public:
+        JournalWriter() = default;
+        JournalWriter(const JournalWriter&) = delete;
+        JournalWriter& operator=(const JournalWriter&) = delete;
+        ~JournalWriter() { close(); }
+
+        // Appends to an existing journal or starts a new one.
+        bool open(const std::string& path) {
+            close();
+            file = fopen(path.c_str(), "ab");
+            if (!file) return false;
+            fseek(file, 0, SEEK_END);
+            if (ftell(file) == 0) {
+                std::uint8_t header[HEADER_BYTES];
+                memcpy(header, MAGIC, sizeof(MAGIC));
+                header[sizeof(MAGIC)] = VERSION;
+                write(header, sizeof(header));
+            }
+            return true;
+        }
+
+        void close() {
+            if (file) fclose(file);
+            file = nullptr;
+        }
+
+        bool isOpen() const { return file != nullptr; }
+
+        // Flushing every record keeps the journal intact if the app crashes; headless
+        // recorders can turn it off and flush once.
+        void setAutoFlush(bool enabled) { autoFlush = enabled; }
+        void flush() { if (file) fflush(file); }
+
+        void newGame(std::uint32_t seed, std::uint64_t layoutHash) {
+            std::uint8_t rec[13];
+            rec[0] = OP_NEW_GAME;
+            for (int i = 0; i < 4; i++) rec[1 + i] = (std::uint8_t)(seed >> (8 * i));
+            for (int i = 0; i < 8; i++) rec[5 + i] = (std::uint8_t)(layoutHash >> (8 * i));
+            write(rec, sizeof(rec));
+        }
+
+        void move(int x, int y) {
+            std::uint8_t rec[3] = { OP_MOVE, (std::uint8_t)(std::int8_t)x, (std::uint8_t)(std::int8_t)y };
+            write(rec, sizeof(rec));
+        }
+
+        void mineAnswer(bool correct) {
+            std::uint8_t rec[2] = { OP_MINE_ANSWER, (std::uint8_t)(correct ? 1 : 0) };
+            write(rec, sizeof(rec));
+        }
+
+        void resetPosition() {
+            std::uint8_t op = OP_RESET_POSITION;
+            write(&op, 1);
+        }
+
+        void revealAll() {
+            std::uint8_t op = OP_REVEAL_ALL;
+            write(&op, 1);
+        }
+    };
+
+    struct Checkpoint {
+        std::uint64_t record = 0;       // index of the record just applied
+        std::uint64_t game = 0;         // games started so far, 1-based
+        std::uint8_t op = 0;
+        bool gameEnd = false;           // this record ended the game
+    };
+
+    struct ReplayOptions {
+        std::uint64_t checkpointEvery = 0;          // 0 = off
+        std::vector<std::uint64_t> checkpoints;     // explicit record indices, ascending
+        bool checkpointAtGameEnd = false;
+    };
+
+    struct ReplayStats {
+        std::uint64_t records = 0;
+        std::uint64_t games = 0;
+        std::uint64_t moves = 0;
+        std::uint64_t mineAnswers = 0;
+        std::uint64_t resets = 0;
+        std::uint64_t layoutMismatches = 0;     // seed no longer produces the recorded dungeon
+        bool truncated = false;                 // file ended inside a record
+        double seconds = 0.0;
+    };
+
+    // Fast-forwards a journal through GameState without any UI. The callback sees
+    // the state after each chosen checkpoint and can render it.
+    class JournalReplayer {
+    public:
+        using CheckpointCallback = std::function<void(const Checkpoint&, const GameState&)>;
+
+    private:
+        std::vector<std::uint8_t> data;
+        std::string error;
+
+        static std::uint64_t readLE(const std::uint8_t* p, int bytes) {
+            std::uint64_t v = 0;
+            for (int i = 0; i < bytes; i++) v |= (std::uint64_t)p[i] << (8 * i);
+            return v;
+        }
+
+    public:
+        bool load(const std::string& path) {
+            data.clear();
+            FILE* f = fopen(path.c_str(), "rb");
+            if (!f) { error = "cannot open journal"; return false; }
+            std::uint8_t chunk[1 << 16];
+            size_t n;
+            while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+            fclose(f);
+
+            if (data.size() < HEADER_BYTES || memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+                error = "not a game journal";
+                return false;
+            }
+            if (data[sizeof(MAGIC)] != VERSION) { error = "unsupported journal version"; return false; }
+            error.clear();
+            return true;
+        }
+
+        const std::string& getError() const { return error; }
+
+        ReplayStats replay(const ReplayOptions& options = ReplayOptions(), const CheckpointCallback& onCheckpoint = nullptr) const {
+            auto t0 = std::chrono::steady_clock::now();
+            ReplayStats stats;
+            std::mt19937 rng;
+            GameState::InitialState empty;
+            GameState state(empty);
+            bool started = false;
+            size_t nextExplicit = 0;
+
+            size_t pos = HEADER_BYTES;
+            while (pos < data.size()) {
+                std::uint8_t op = data[pos];
+                size_t payload = op == OP_NEW_GAME ? 12 : op == OP_MOVE ? 2 : op == OP_MINE_ANSWER ? 1 : 0;
+                if (op < OP_NEW_GAME || op > OP_REVEAL_ALL || pos + 1 + payload > data.size()) {
+                    stats.truncated = true;
+                    break;
+                }
+                const std::uint8_t* p = data.data() + pos + 1;
+                pos += 1 + payload;
+
+                bool wasOver = state.isGameOver();
+                if (op == OP_NEW_GAME) {
+                    rng.seed((std::uint32_t)readLE(p, 4));
+                    state = GameState(rng);
+                    if (state.getInitialState().layoutHash != readLE(p + 4, 8)) stats.layoutMismatches++;
+                    stats.games++;
+                    started = true;
+                    wasOver = false;
+                }
+                else if (started) {
+                    if (op == OP_MOVE) {
+                        state.movePlayer((std::int8_t)p[0], (std::int8_t)p[1]);
+                        stats.moves++;
+                    }
+                    else if (op == OP_MINE_ANSWER) {
+                        if (!p[0]) state.applyMinePenalty();
+                        stats.mineAnswers++;
+                    }
+                    else if (op == OP_RESET_POSITION) {
+                        state.resetPlayerPosition();
+                        stats.resets++;
+                    }
+                    else if (op == OP_REVEAL_ALL) {
+                        state.revealAll();
+                    }
+                }
+
+                std::uint64_t record = stats.records++;
+                if (!onCheckpoint) continue;
+                Checkpoint cp;
+                cp.record = record;
+                cp.game = stats.games;
+                cp.op = op;
+                cp.gameEnd = !wasOver && state.isGameOver();
+
+                bool hit = (options.checkpointEvery > 0 && (record + 1) % options.checkpointEvery == 0)
+                    || (options.checkpointAtGameEnd && cp.gameEnd);
+                while (nextExplicit < options.checkpoints.size() && options.checkpoints[nextExplicit] <= record) {
+                    if (options.checkpoints[nextExplicit] == record) hit = true;
+                    nextExplicit++;
+                }
+                if (hit) onCheckpoint(cp, state);
+            }
+
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            return stats;
+        }
+    };
+}
@@ -7,6 +7,13 @@
 #include <algorithm>
 #include <iostream>
 #include <functional>
+#include <cstdint>
+#include <type_traits>
+#include "DungeonGenerator.h"
+#include "EventQueue.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 class GameState {
 public:
@@ -22,7 +29,103 @@ public:
     static const int PATH_VISUAL = 6;
     static const int EXPLORED_NODE = 7;
 
-    using GameEventCallback = std::function<void(const std::string& event, int value)>;
+    enum class EventType : std::uint8_t { Reward, Bandit, Mine, Exit, ExitInsufficient };
+
+    // Reward: gold found. Mine: gold at stake. ExitInsufficient: gold held.
+    struct Event {
+        EventType type = EventType::Reward;
+        std::int32_t value = 0;
+    };
+
+    // Filled by movePlayer, drained by the consumer (the canvas once per frame,
+    // the headless engine after each move).
+    using EventQueue = SpscQueue<Event, 64>;
+
+    // One bit per cell, bit index x * GRID_SIZE + y.
+    struct CellMask {
+        std::uint64_t lo = 0, hi = 0;
+
+        static int bit(int x, int y) { return x * GRID_SIZE + y; }
+
+        bool test(int i) const { return i < 64 ? ((lo >> i) & 1) != 0 : ((hi >> (i - 64)) & 1) != 0; }
+        bool test(int x, int y) const { return test(bit(x, y)); }
+        void set(int i) { if (i < 64) lo |= 1ull << i; else hi |= 1ull << (i - 64); }
+        void set(int x, int y) { set(bit(x, y)); }
+        void clear(int i) { if (i < 64) lo &= ~(1ull << i); else hi &= ~(1ull << (i - 64)); }
+        void clear(int x, int y) { clear(bit(x, y)); }
+        bool any() const { return (lo | hi) != 0; }
+
+        static int lowestBit(std::uint64_t v) {
+#ifdef _MSC_VER
+            unsigned long i;
+            _BitScanForward64(&i, v);
+            return (int)i;
+#else
+            return __builtin_ctzll(v);
+#endif
+        }
+
+        // Calls f(bit) for each set bit in ascending order; cost is per set bit.
+        template <typename F>
+        void forEach(F&& f) const {
+            for (std::uint64_t w = lo; w; w &= w - 1) f(lowestBit(w));
+            for (std::uint64_t w = hi; w; w &= w - 1) f(64 + lowestBit(w));
+        }
+
+        static CellMask all() {
+            CellMask m;
+            const int n = GRID_SIZE * GRID_SIZE;
+            m.lo = n >= 64 ? ~0ull : (1ull << n) - 1;
+            m.hi = n >= 128 ? ~0ull : (n > 64 ? (1ull << (n - 64)) - 1 : 0);
+            return m;
+        }
+
+        CellMask operator|(const CellMask& o) const { return { lo | o.lo, hi | o.hi }; }
+        CellMask operator&(const CellMask& o) const { return { lo & o.lo, hi & o.hi }; }
+        CellMask operator^(const CellMask& o) const { return { lo ^ o.lo, hi ^ o.hi }; }
+        CellMask without(const CellMask& o) const { return { lo & ~o.lo, hi & ~o.hi }; }
+        bool operator==(const CellMask& o) const { return lo == o.lo && hi == o.hi; }
+        bool operator!=(const CellMask& o) const { return !(*this == o); }
+    };
+    static_assert(GRID_SIZE * GRID_SIZE <= 128, "CellMask holds at most 128 cells");
+
+    // Everything movePlayer can change, in one trivially copyable block so search and
+    // rollout code can snapshot/restore a game with a plain copy.
+    struct Board {
+        CellMask reward, bandit, mine;      // tiles still on the map (consumed when stepped on)
+        CellMask exit;
+        CellMask revealed;                  // cells whose actual content is shown
+        std::int8_t playerX = 0, playerY = 0;
+        std::int8_t standingOn = PLAYER;    // what the player's cell shows (the tile just consumed)
+        std::uint8_t flags = 0;
+        std::int16_t gold = 0;
+        std::int16_t collectedRewards = 0;
+        std::uint64_t hash = 0;             // Zobrist hash of tiles, player cell and gold
+
+        static const std::uint8_t GAME_OVER = 1, GAME_WON = 2, REACHED_EXIT = 4;
+
+        bool flag(std::uint8_t f) const { return (flags & f) != 0; }
+        void setFlag(std::uint8_t f, bool on) { flags = on ? (flags | f) : (flags & ~f); }
+
+        // Tile as the original int grid stored it; the player's cell reads as PLAYER.
+        int actualCell(int x, int y) const {
+            if (x == playerX && y == playerY) return PLAYER;
+            int i = CellMask::bit(x, y);
+            if (reward.test(i)) return REWARD;
+            if (bandit.test(i)) return BANDIT;
+            if (mine.test(i)) return MINE;
+            if (exit.test(i)) return EXIT;
+            return EMPTY;
+        }
+
+        int displayCell(int x, int y) const {
+            if (x == playerX && y == playerY) return standingOn;
+            int i = CellMask::bit(x, y);
+            if (revealed.test(i) || exit.test(i)) return actualCell(x, y);
+            return EMPTY;
+        }
+    };
+    static_assert(std::is_trivially_copyable<Board>::value, "Board must stay memcpy-able");
 
     struct InitialState {
         int actualGrid[GRID_SIZE][GRID_SIZE] = { {0} };
@@ -33,78 +136,145 @@ public:
         std::vector<std::pair<int, int>> rewards;
         std::vector<std::pair<int, int>> bandits;
         std::vector<std::pair<int, int>> mines;
+        std::uint64_t layoutHash = 0;       // GameState::layoutHash of this layout
     };
 
-private:
+    // Fixed Zobrist keys. They come from SplitMix64 with a constant seed, so hashes
+    // are stable across runs, platforms and standard library versions.
+    struct ZobristKeys {
+        static const int GOLD_KEYS = 256;
+
+        std::uint64_t tile[EXIT + 1][GRID_SIZE * GRID_SIZE];   // REWARD..EXIT used
+        std::uint64_t player[GRID_SIZE * GRID_SIZE];
+        std::uint64_t gold[GOLD_KEYS];
+
+        ZobristKeys() {
+            std::uint64_t state = 0x5EED0F0D06E0A5EDull;
+            auto next = [&state]() {
+                std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            };
+            for (auto& row : tile) for (auto& k : row) k = next();
+            for (auto& k : player) k = next();
+            for (auto& k : gold) k = next();
+        }
 
-    int playerX = 0, playerY = 0;
-    int gold = 0;
-    int collectedRewards = 0;
-    bool gameOver = false, gameWon = false, hasReachedExitOnce = false;
+        std::uint64_t goldKey(int g) const { return gold[(g < 0 ? 0 : g) % GOLD_KEYS]; }
+    };
+
+    static const ZobristKeys& zobrist() {
+        static const ZobristKeys keys;
+        return keys;
+    }
+
+private:
 
-    int actualGrid[GRID_SIZE][GRID_SIZE];
-    int displayGrid[GRID_SIZE][GRID_SIZE];
+    Board board;
+    Board initialBoard;
     InitialState initialState;
 
+    // Algorithm overlay drawn by visualizePath on top of the initial layout.
+    bool visualizing = false;
+    CellMask pathMask, exploredMask;
+    mutable int displayCache[GRID_SIZE][GRID_SIZE];
+
     std::vector<std::pair<int, int>> exploredNodes;
-    GameEventCallback gameEventCallback;
+    EventQueue* eventQueue = nullptr;
+
+    // Cells whose getDisplayCell value may have changed since clearDirty(), as a
+    // bitset and as a list in the order they were first touched.
+    CellMask dirtyMask;
+    std::uint8_t dirtyCells[GRID_SIZE * GRID_SIZE];
+    int dirtyCount = 0;
 
 
     void initializeGame(std::mt19937& rng) {
-        memset(actualGrid, 0, sizeof(actualGrid));
-        memset(displayGrid, 0, sizeof(displayGrid));
+        // Rejection-free placement with a winnability check; buffers are reused per thread.
+        static thread_local DungeonGen::DungeonGenerator generator;
+        static thread_local DungeonGen::Dungeon dungeon;
+        // Each call draws maxAttempts fresh candidates; the default 10x10 mix passes in
+        // almost every first attempt, so this only repeats on a very unlucky stream.
+        while (!generator.generate(rng, dungeon)) {}
+        initialStateFromDungeon(dungeon, initialState);
+        startGame();
+    }
+
+    void startGame() {
         exploredNodes.clear();
+        visualizing = false;
+        initialBoard = boardFromInitialState(initialState);
+        board = initialBoard;
+        markDirty(CellMask::all());
+    }
+
+    void markDirty(int bit) {
+        if (dirtyMask.test(bit)) return;
+        dirtyMask.set(bit);
+        dirtyCells[dirtyCount++] = (std::uint8_t)bit;
+    }
+
+    void markDirty(const CellMask& cells) {
+        cells.without(dirtyMask).forEach([this](int bit) {
+            dirtyCells[dirtyCount++] = (std::uint8_t)bit;
+            });
+        dirtyMask = dirtyMask | cells;
+    }
+
+    // Cells that can display differently on two boards.
+    static CellMask changedCells(const Board& a, const Board& b) {
+        CellMask d = (a.reward ^ b.reward) | (a.bandit ^ b.bandit) | (a.mine ^ b.mine)
+            | (a.exit ^ b.exit) | (a.revealed ^ b.revealed);
+        if (a.playerX != b.playerX || a.playerY != b.playerY || a.standingOn != b.standingOn) {
+            d.set(a.playerX, a.playerY);
+            d.set(b.playerX, b.playerY);
+        }
+        return d;
+    }
 
-        gold = 0;
-        collectedRewards = 0;
-        gameOver = false;
-        gameWon = false;
-        hasReachedExitOnce = false;
-
-        initialState.rewards.clear();
-        initialState.bandits.clear();
-        initialState.mines.clear();
-
-        std::uniform_int_distribution<int> rowDist(0, GRID_SIZE - 1);
-        std::uniform_int_distribution<int> playerRowDist(0, GRID_SIZE - 1);
-
-        playerX = 0;
-        playerY = playerRowDist(rng);
-        actualGrid[playerX][playerY] = PLAYER;
-        displayGrid[playerX][playerY] = PLAYER;
-        initialState.playerStartX = playerX;
-        initialState.playerStartY = playerY;
-
-        int exitRow = rowDist(rng);
-        actualGrid[GRID_SIZE - 1][exitRow] = EXIT;
-        displayGrid[GRID_SIZE - 1][exitRow] = EXIT;
-        initialState.exitX = GRID_SIZE - 1;
-        initialState.exitY = exitRow;
-
-        for (int i = 0; i < 5; i++) placeRandomTile(rng, actualGrid, REWARD, &initialState.rewards);
-        for (int i = 0; i < 5; i++) placeRandomTile(rng, actualGrid, BANDIT, &initialState.bandits);
-        for (int i = 0; i < 5; i++) placeRandomTile(rng, actualGrid, MINE, &initialState.mines);
-
-        memcpy(initialState.actualGrid, actualGrid, sizeof(actualGrid));
+    // Switching between the board and the algorithm overlay can only change cells
+    // that hold a tile, the overlay, start, exit or the player.
+    void setVisualizing(bool on) {
+        if (on == visualizing) return;
+        CellMask cells = initialBoard.reward | initialBoard.bandit | initialBoard.mine
+            | board.reward | board.bandit | board.mine | pathMask | exploredMask | initialBoard.exit;
+        cells.set(initialState.playerStartX, initialState.playerStartY);
+        cells.set(board.playerX, board.playerY);
+        markDirty(cells);
+        visualizing = on;
     }
 
-    static void placeRandomTile(std::mt19937& rng, int grid[GRID_SIZE][GRID_SIZE], int tileType,
-        std::vector<std::pair<int, int>>* positions = nullptr)
-    {
-        std::uniform_int_distribution<int> colDist(1, GRID_SIZE - 2);
-        std::uniform_int_distribution<int> rowDist(0, GRID_SIZE - 1);
-
-        int x, y, attempts = 0;
-        do {
-            x = colDist(rng);
-            y = rowDist(rng);
-            attempts++;
-        } while (grid[x][y] != 0 && attempts < 100);
-
-        if (grid[x][y] == 0) {
-            grid[x][y] = tileType;
-            if (positions) positions->push_back({ x, y });
+    static Board boardFromInitialState(const InitialState& s) {
+        Board b;
+        for (int x = 0; x < GRID_SIZE; x++) {
+            for (int y = 0; y < GRID_SIZE; y++) {
+                int cell = s.actualGrid[x][y];
+                if (cell == REWARD) b.reward.set(x, y);
+                else if (cell == BANDIT) b.bandit.set(x, y);
+                else if (cell == MINE) b.mine.set(x, y);
+                else if (cell == EXIT) b.exit.set(x, y);
+            }
         }
+        b.playerX = (std::int8_t)s.playerStartX;
+        b.playerY = (std::int8_t)s.playerStartY;
+        b.standingOn = PLAYER;
+        b.hash = computeHash(b);
+        return b;
+    }
+
+    void setGold(int newGold) {
+        board.hash ^= zobrist().goldKey(board.gold) ^ zobrist().goldKey(newGold);
+        board.gold = (std::int16_t)newGold;
+    }
+
+    void emit(EventType type, int value) {
+        if (eventQueue) eventQueue->push({ type, (std::int32_t)value });
+    }
+
+    void consumeTile(CellMask& mask, int type, int bit) {
+        mask.clear(bit);
+        board.hash ^= zobrist().tile[type][bit];
     }
 
 public:
@@ -112,25 +282,125 @@ public:
         initializeGame(rng);
     }
 
-    const int (*getDisplayGrid() const)[GRID_SIZE] { return displayGrid; }
+    // Replays a known layout (corpus entry, journal, tournament seed set).
+    explicit GameState(const InitialState& layout) : initialState(layout) {
+        initialState.layoutHash = layoutHash(initialState);
+        startGame();
+    }
+
+    // Converts a generated GRID_SIZE x GRID_SIZE dungeon; false for other sizes.
+    static bool initialStateFromDungeon(const DungeonGen::Dungeon& d, InitialState& s) {
+        if (d.width != GRID_SIZE || d.height != GRID_SIZE) return false;
+        s = InitialState();
+        s.playerStartX = d.startX; s.playerStartY = d.startY;
+        s.exitX = d.exitX; s.exitY = d.exitY;
+        for (int x = 0; x < GRID_SIZE; x++) {
+            for (int y = 0; y < GRID_SIZE; y++) {
+                int cell = d.at(x, y);
+                s.actualGrid[x][y] = cell;
+                if (cell == REWARD) s.rewards.push_back({ x, y });
+                else if (cell == BANDIT) s.bandits.push_back({ x, y });
+                else if (cell == MINE) s.mines.push_back({ x, y });
+            }
+        }
+        s.layoutHash = layoutHash(s);
+        return true;
+    }
+
+    const int (*getDisplayGrid() const)[GRID_SIZE] {
+        for (int i = 0; i < GRID_SIZE; i++)
+            for (int j = 0; j < GRID_SIZE; j++)
+                displayCache[i][j] = getDisplayCell(i, j);
+        return displayCache;
+    }
     const InitialState& getInitialState() const { return initialState; }
-    int getPlayerX() const { return playerX; }
-    int getPlayerY() const { return playerY; }
-    int getGold() const { return gold; }
-    int getCollectedRewards() const { return collectedRewards; }
-    bool isGameOver() const { return gameOver; }
-    bool isGameWon() const { return gameWon; }
-    bool hasMetRewardRequirement() const { return gold >= 20; }
-    bool hasEverReachedExit() const { return hasReachedExitOnce; }
+    int getPlayerX() const { return board.playerX; }
+    int getPlayerY() const { return board.playerY; }
+    int getGold() const { return board.gold; }
+    int getCollectedRewards() const { return board.collectedRewards; }
+    bool isGameOver() const { return board.flag(Board::GAME_OVER); }
+    bool isGameWon() const { return board.flag(Board::GAME_WON); }
+    bool hasMetRewardRequirement() const { return board.gold >= 20; }
+    bool hasEverReachedExit() const { return board.flag(Board::REACHED_EXIT); }
+
+    // Full recompute; movePlayer and friends keep Board::hash up to date incrementally.
+    static std::uint64_t computeHash(const Board& b) {
+        const ZobristKeys& z = zobrist();
+        std::uint64_t h = z.player[CellMask::bit(b.playerX, b.playerY)] ^ z.goldKey(b.gold);
+        for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+            if (b.reward.test(i)) h ^= z.tile[REWARD][i];
+            if (b.bandit.test(i)) h ^= z.tile[BANDIT][i];
+            if (b.mine.test(i)) h ^= z.tile[MINE][i];
+            if (b.exit.test(i)) h ^= z.tile[EXIT][i];
+        }
+        return h;
+    }
+
+    // Identity of a generated dungeon (tiles, start and exit), independent of play.
+    // Equal to the hash of the game's starting Board. This is the layout key shared by
+    // the journal and the corpus index.
+    static std::uint64_t layoutHash(const InitialState& s) {
+        return layoutHash(s.playerStartX, s.playerStartY, [&s](int x, int y) { return s.actualGrid[x][y]; });
+    }
+
+    // The same hash for GRID_SIZE x GRID_SIZE tiles stored column-major (x * GRID_SIZE + y).
+    static std::uint64_t layoutHash(const std::uint8_t* tiles, int startX, int startY) {
+        return layoutHash(startX, startY, [tiles](int x, int y) { return (int)tiles[x * GRID_SIZE + y]; });
+    }
+
+    template <typename TileAt>
+    static std::uint64_t layoutHash(int startX, int startY, TileAt at) {
+        const ZobristKeys& z = zobrist();
+        std::uint64_t h = z.player[CellMask::bit(startX, startY)] ^ z.goldKey(0);
+        for (int x = 0; x < GRID_SIZE; x++) {
+            for (int y = 0; y < GRID_SIZE; y++) {
+                int cell = at(x, y);
+                if (cell >= REWARD && cell <= EXIT) h ^= z.tile[cell][CellMask::bit(x, y)];
+            }
+        }
+        return h;
+    }
+
+    std::uint64_t getHash() const { return board.hash; }
+
+    // Snapshot/restore for lookahead search; a Board is a plain copy.
+    const Board& getBoard() const { return board; }
+    void restoreBoard(const Board& snapshot) {
+        markDirty(changedCells(board, snapshot));
+        board = snapshot;
+    }
+
+    // Change tracking for incremental consumers (renderers, replays). Owned by one
+    // consumer, which reads the list and then calls clearDirty().
+    const std::uint8_t* getDirtyCells() const { return dirtyCells; }
+    int getDirtyCount() const { return dirtyCount; }
+    const CellMask& getDirtyMask() const { return dirtyMask; }
+    static int cellX(int bit) { return bit / GRID_SIZE; }
+    static int cellY(int bit) { return bit % GRID_SIZE; }
+
+    void clearDirty() {
+        dirtyMask = CellMask();
+        dirtyCount = 0;
+    }
 
     int getDisplayCell(int x, int y) const {
-        if (x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE)
-            return displayGrid[x][y];
-        return EMPTY;
+        if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE)
+            return EMPTY;
+        if (visualizing) {
+            int cell = initialState.actualGrid[x][y];
+            if (cell >= REWARD && cell <= MINE) return cell;
+            if (x == initialState.playerStartX && y == initialState.playerStartY) return PLAYER;
+            if (x == initialState.exitX && y == initialState.exitY) return EXIT;
+            if (pathMask.test(x, y)) return PATH_VISUAL;
+            if (exploredMask.test(x, y)) return EXPLORED_NODE;
+            return EMPTY;
+        }
+        return board.displayCell(x, y);
     }
 
-    void setGameEventCallback(const GameEventCallback& callback) {
-        gameEventCallback = callback;
+    // nullptr (the default) ignores events.
+    void setEventQueue(EventQueue* queue) {
+        eventQueue = queue;
     }
 
     void setExploredNodes(const std::vector<std::pair<int, int>>& nodes) {
@@ -142,56 +412,52 @@ public:
     }
 
     void applyMinePenalty() {
-        gold = std::max(0, gold - 5);
+        setGold(std::max(0, board.gold - 5));
     }
 
     bool movePlayer(int newX, int newY) {
-        if (gameOver || newX < 0 || newX >= GRID_SIZE || newY < 0 || newY >= GRID_SIZE)
+        if (isGameOver() || newX < 0 || newX >= GRID_SIZE || newY < 0 || newY >= GRID_SIZE)
             return false;
 
-        int cellType = actualGrid[newX][newY];
-
-        actualGrid[playerX][playerY] = EMPTY;
-        displayGrid[playerX][playerY] = EMPTY;
-
-        playerX = newX;
-        playerY = newY;
-
-        if (cellType == REWARD) {
-            gold += 10;
-            collectedRewards++;
-            actualGrid[newX][newY] = PLAYER;
-            displayGrid[newX][newY] = REWARD;
-            if (gameEventCallback) gameEventCallback("reward", 10);
+        int bit = CellMask::bit(newX, newY);
+        setVisualizing(false);
+        markDirty(CellMask::bit(board.playerX, board.playerY));
+        markDirty(bit);
+        board.hash ^= zobrist().player[CellMask::bit(board.playerX, board.playerY)] ^ zobrist().player[bit];
+        board.playerX = (std::int8_t)newX;
+        board.playerY = (std::int8_t)newY;
+
+        if (board.reward.test(bit)) {
+            consumeTile(board.reward, REWARD, bit);
+            setGold(board.gold + 10);
+            board.collectedRewards++;
+            board.standingOn = REWARD;
+            emit(EventType::Reward, 10);
         }
-        else if (cellType == BANDIT) {
-            gold = gold / 2;
-            actualGrid[newX][newY] = PLAYER;
-            displayGrid[newX][newY] = BANDIT;
-            if (gameEventCallback) gameEventCallback("bandit", 0);
+        else if (board.bandit.test(bit)) {
+            consumeTile(board.bandit, BANDIT, bit);
+            setGold(board.gold / 2);
+            board.standingOn = BANDIT;
+            emit(EventType::Bandit, 0);
         }
-        else if (cellType == MINE) {
-            actualGrid[newX][newY] = PLAYER;
-            displayGrid[newX][newY] = MINE;
-            if (gameEventCallback) gameEventCallback("mine", 5);
+        else if (board.mine.test(bit)) {
+            consumeTile(board.mine, MINE, bit);
+            board.standingOn = MINE;
+            emit(EventType::Mine, 5);
         }
-        else if (cellType == EXIT) {
-            actualGrid[newX][newY] = PLAYER;
-            displayGrid[newX][newY] = PLAYER;
-            gameOver = true;
-            gameWon = true;
-            hasReachedExitOnce = true;
-            if (gold >= 20) {
+        else if (board.exit.test(bit)) {
+            board.standingOn = PLAYER;
+            board.setFlag(Board::GAME_OVER | Board::GAME_WON | Board::REACHED_EXIT, true);
+            if (board.gold >= 20) {
                 revealAll();
-                if (gameEventCallback) gameEventCallback("exit", 0);
+                emit(EventType::Exit, 0);
             }
             else {
-                if (gameEventCallback) gameEventCallback("exit_insufficient", gold);
+                emit(EventType::ExitInsufficient, board.gold);
             }
         }
         else {
-            actualGrid[newX][newY] = PLAYER;
-            displayGrid[newX][newY] = PLAYER;
+            board.standingOn = PLAYER;
         }
 
         return true;
@@ -199,66 +465,34 @@ public:
 
 
     void revealAll() {
-        for (int i = 0; i < GRID_SIZE; i++)
-            for (int j = 0; j < GRID_SIZE; j++)
-                displayGrid[i][j] = actualGrid[i][j];
-        displayGrid[playerX][playerY] = PLAYER;
+        // Newly revealed cells only change if they still hold a tile.
+        markDirty(CellMask::all().without(board.revealed) & (board.reward | board.bandit | board.mine));
+        if (board.standingOn != PLAYER) markDirty(CellMask::bit(board.playerX, board.playerY));
+        board.revealed = CellMask::all();
+        board.standingOn = PLAYER;
     }
 
     void resetPlayerPosition() {
-        memcpy(actualGrid, initialState.actualGrid, sizeof(actualGrid));
-        memset(displayGrid, 0, sizeof(displayGrid));
-
-        playerX = initialState.playerStartX;
-        playerY = initialState.playerStartY;
-        actualGrid[playerX][playerY] = PLAYER;
-        displayGrid[playerX][playerY] = PLAYER;
-        displayGrid[initialState.exitX][initialState.exitY] = EXIT;
-
-        gold = 0;
-        collectedRewards = 0;
-        gameOver = false;
-        gameWon = false;
+        bool reachedExit = hasEverReachedExit();
+        setVisualizing(false);
+        markDirty(changedCells(board, initialBoard));
+        board = initialBoard;
+        board.setFlag(Board::REACHED_EXIT, reachedExit);
     }
 
     void visualizePath(const std::vector<std::pair<int, int>>& path) {
-        memset(displayGrid, 0, sizeof(displayGrid));
-        displayGrid[initialState.playerStartX][initialState.playerStartY] = PLAYER;
-        displayGrid[initialState.exitX][initialState.exitY] = EXIT;
-
-        for (auto& pos : exploredNodes) {
-            int x = pos.first, y = pos.second;
-            if (x == initialState.playerStartX && y == initialState.playerStartY) continue;
-            if (x == initialState.exitX && y == initialState.exitY) continue;
-            int cell = initialState.actualGrid[x][y];
-            if (cell < REWARD || cell > MINE)
-                displayGrid[x][y] = EXPLORED_NODE;
-        }
-
-        for (auto& pos : path) {
-            int x = pos.first, y = pos.second;
-            if (x == initialState.playerStartX && y == initialState.playerStartY) continue;
-            if (x == initialState.exitX && y == initialState.exitY) continue;
-            displayGrid[x][y] = PATH_VISUAL;
-        }
-
-        for (int i = 0; i < GRID_SIZE; i++)
-            for (int j = 0; j < GRID_SIZE; j++) {
-                int cell = initialState.actualGrid[i][j];
-                if (cell >= REWARD && cell <= MINE)
-                    displayGrid[i][j] = cell;
-            }
+        CellMask oldPath = pathMask, oldExplored = exploredMask;
+        pathMask = CellMask();
+        exploredMask = CellMask();
+        for (auto& pos : exploredNodes) exploredMask.set(pos.first, pos.second);
+        for (auto& pos : path) pathMask.set(pos.first, pos.second);
+        if (visualizing) markDirty((oldPath ^ pathMask) | (oldExplored ^ exploredMask));
+        setVisualizing(true);
     }
 
     void resetVisualization() {
         exploredNodes.clear();
-        if (gameOver) {
-            revealAll();
-        }
-        else {
-            for (int i = 0; i < GRID_SIZE; i++)
-                for (int j = 0; j < GRID_SIZE; j++)
-                    displayGrid[i][j] = actualGrid[i][j];
-        }
+        setVisualizing(false);
+        revealAll();
     }
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Read-only view of a column-major dungeon grid (cell (x, y) lives at x * height + y),
+// the same layout as int grid[x][y]. Cells may be stored as int or as one byte each,
+// so solvers can run directly on GameState arrays or on packed corpus records.
+struct GridView {
+    const void* cells = nullptr;
+    int width = 0;
+    int height = 0;
+    int cellBytes = sizeof(int);
+
+    GridView() = default;
+
+    GridView(const int* data, int w, int h)
+        : cells(data), width(w), height(h), cellBytes(sizeof(int)) {}
+
+    GridView(const std::uint8_t* data, int w, int h)
+        : cells(data), width(w), height(h), cellBytes(1) {}
+
+    // Square int grid as passed around by GameState (int grid[N][N]).
+    template <size_t N>
+    GridView(const int (*grid)[N])
+        : cells(grid), width((int)N), height((int)N), cellBytes(sizeof(int)) {}
+
+    inline int at(int x, int y) const {
+        size_t i = (size_t)x * height + y;
+        if (cellBytes == 1) return static_cast<const std::uint8_t*>(cells)[i];
+        return static_cast<const int*>(cells)[i];
+    }
+
+    inline bool contains(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+
+    size_t cellCount() const { return (size_t)width * height; }
+};
@@ -0,0 +1,243 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <string>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include "GameState.h"
+#include "Algorithms.h"
+#include "Rollout.h"
+#include "DungeonCorpus.h"
+#include "GameJournal.h"
+
+// Runs GameState without a window: generates dungeons, drives movePlayer from a
+// planner or a scripted key sequence, and answers mine questions from a success
+// model instead of a dialog. Nothing here depends on natGUI.
+namespace DungeonHeadless {
+
+    enum class Planner { Script, Random, BFS, DFS, Dijkstra, AStar, Greedy, MDP };
+
+    inline const char* plannerName(Planner p) {
+        switch (p) {
+        case Planner::Script:   return "script";
+        case Planner::Random:   return "random";
+        case Planner::BFS:      return "bfs";
+        case Planner::DFS:      return "dfs";
+        case Planner::Dijkstra: return "dijkstra";
+        case Planner::AStar:    return "astar";
+        case Planner::Greedy:   return "greedy";
+        case Planner::MDP:      return "mdp";
+        }
+        return "";
+    }
+
+    inline bool parsePlanner(const std::string& name, Planner& out) {
+        for (Planner p : { Planner::Script, Planner::Random, Planner::BFS, Planner::DFS,
+                           Planner::Dijkstra, Planner::AStar, Planner::Greedy, Planner::MDP }) {
+            if (name == plannerName(p)) { out = p; return true; }
+        }
+        return false;
+    }
+
+    struct EngineOptions {
+        std::uint64_t games = 1000;
+        std::uint64_t seed = 1;
+        Planner planner = Planner::AStar;
+        std::string script;                 // WASD keys, same mapping as the canvas
+        double mineSuccessProbability = DungeonMDP::MINE_SUCCESS_PROBABILITY;
+        int maxMoves = 400;                 // per game, for random walks and looping scripts
+        int threads = 1;
+        // When set, game i plays corpus record i % size instead of a seeded dungeon.
+        const DungeonCorpus::CorpusReader* corpus = nullptr;
+        // When set, seeded games are journaled for replay; forces a single thread.
+        // Corpus games are not journaled, since replay regenerates dungeons from seeds.
+        DungeonJournal::JournalWriter* journal = nullptr;
+    };
+
+    struct GameOutcome {
+        bool reachedExit = false;
+        bool won = false;
+        int gold = 0;
+        int moves = 0;
+        int rewards = 0, bandits = 0, mines = 0, minesFailed = 0;
+    };
+
+    struct EngineStats {
+        std::uint64_t games = 0;
+        std::uint64_t wins = 0;
+        std::uint64_t poorExits = 0;
+        std::uint64_t stuck = 0;
+        std::uint64_t moves = 0;
+        std::uint64_t rewards = 0, bandits = 0, mines = 0, minesFailed = 0;
+        std::uint64_t goldSum = 0;
+        double seconds = 0.0;               // wall time for the whole run
+        double moveSeconds = 0.0;           // summed time spent inside movePlayer
+        double planSeconds = 0.0;           // summed time spent in planners
+
+        void add(const GameOutcome& o) {
+            games++;
+            if (o.won) wins++;
+            else if (o.reachedExit) poorExits++;
+            else stuck++;
+            moves += o.moves;
+            rewards += o.rewards; bandits += o.bandits; mines += o.mines; minesFailed += o.minesFailed;
+            goldSum += o.gold;
+        }
+
+        void merge(const EngineStats& o) {
+            games += o.games; wins += o.wins; poorExits += o.poorExits; stuck += o.stuck;
+            moves += o.moves; rewards += o.rewards; bandits += o.bandits;
+            mines += o.mines; minesFailed += o.minesFailed; goldSum += o.goldSum;
+            moveSeconds += o.moveSeconds; planSeconds += o.planSeconds;
+        }
+
+        double winRate() const { return games ? (double)wins / games : 0.0; }
+        double meanGold() const { return games ? (double)goldSum / games : 0.0; }
+        double movesPerSecond() const { return moveSeconds > 0.0 ? moves / moveSeconds : 0.0; }
+    };
+
+    class HeadlessEngine {
+    private:
+        EngineOptions options;
+
+        // Per-game state updated from the game's event queue.
+        struct Session {
+            GameOutcome outcome;
+            DungeonRollout::CounterRng mineRng;
+            double mineSuccess;
+            GameState* state = nullptr;
+            DungeonJournal::JournalWriter* journal = nullptr;
+
+            Session(std::uint64_t seed, std::uint64_t game, double p) : mineRng(seed, game), mineSuccess(p) {}
+
+            void onEvent(const GameState::Event& event) {
+                if (event.type == GameState::EventType::Reward) outcome.rewards++;
+                else if (event.type == GameState::EventType::Bandit) outcome.bandits++;
+                else if (event.type == GameState::EventType::Mine) {
+                    outcome.mines++;
+                    bool correct = mineRng.uniform() < mineSuccess;
+                    if (journal) journal->mineAnswer(correct);
+                    if (!correct) {
+                        outcome.minesFailed++;
+                        state->applyMinePenalty();
+                    }
+                }
+            }
+        };
+
+        static bool keyToMove(char ch, int& dx, int& dy) {
+            dx = dy = 0;
+            if (ch == 'w' || ch == 'W') dy = -1;
+            else if (ch == 's' || ch == 'S') dy = 1;
+            else if (ch == 'a' || ch == 'A') dx = -1;
+            else if (ch == 'd' || ch == 'D') dx = 1;
+            else return false;
+            return true;
+        }
+
+        std::vector<std::pair<int, int>> plan(const GameState::InitialState& s) const {
+            std::pair<int, int> start = { s.playerStartX, s.playerStartY };
+            std::pair<int, int> exit = { s.exitX, s.exitY };
+            switch (options.planner) {
+            case Planner::BFS:      return DungeonAlgorithms::bfsSearch(s.actualGrid, start, exit).path;
+            case Planner::DFS:      return DungeonAlgorithms::dfsSearch(s.actualGrid, start, exit).path;
+            case Planner::Dijkstra: return DungeonAlgorithms::dijkstraSearch(s.actualGrid, start, exit).path;
+            case Planner::AStar:    return DungeonAlgorithms::aStarSearch(s.actualGrid, start, exit).path;
+            case Planner::Greedy:   return DungeonAlgorithms::greedySearch(s.actualGrid, start, exit).path;
+            case Planner::MDP:      return DungeonAlgorithms::mdpSearch(s.actualGrid, start, exit, 0).path;
+            default:                return {};
+            }
+        }
+
+    public:
+        explicit HeadlessEngine(const EngineOptions& opts) : options(opts) {}
+
+        GameState makeState(std::uint64_t game) const {
+            GameState::InitialState layout;
+            if (options.corpus && options.corpus->toInitialState((size_t)(game % options.corpus->size()), layout))
+                return GameState(layout);
+            std::mt19937 rng(static_cast<std::mt19937::result_type>(options.seed + game));
+            return GameState(rng);
+        }
+
+        GameOutcome playGame(std::uint64_t game, EngineStats& stats) const {
+            GameState state = makeState(game);
+            Session session(options.seed, game, options.mineSuccessProbability);
+            session.state = &state;
+            DungeonJournal::JournalWriter* journal = options.corpus ? nullptr : options.journal;
+            session.journal = journal;
+            if (journal) journal->newGame((std::uint32_t)(options.seed + game), state.getInitialState().layoutHash);
+            GameState::EventQueue events;
+            state.setEventQueue(&events);
+            // Events are handled right after the move that raised them, as the UI would.
+            auto move = [&state, &session, &events, journal](int x, int y) {
+                if (journal) journal->move(x, y);
+                bool moved = state.movePlayer(x, y);
+                events.drain([&session](const GameState::Event& e) { session.onEvent(e); });
+                return moved;
+            };
+
+            auto t0 = std::chrono::steady_clock::now();
+            std::vector<std::pair<int, int>> path = plan(state.getInitialState());
+            auto t1 = std::chrono::steady_clock::now();
+
+            GameOutcome& out = session.outcome;
+            if (options.planner == Planner::Script || options.planner == Planner::Random) {
+                DungeonRollout::CounterRng walk(options.seed ^ 0xD1B54A32D192ED03ull, game);
+                size_t len = options.script.size();
+                for (int i = 0; i < options.maxMoves && !state.isGameOver(); i++) {
+                    int dx, dy;
+                    if (options.planner == Planner::Script) {
+                        if (len == 0) break;
+                        if (!keyToMove(options.script[i % len], dx, dy)) continue;
+                    }
+                    else {
+                        int a = (int)(walk.uniform() * DungeonMDP::NUM_ACTIONS);
+                        dx = DungeonMDP::DIRECTIONS[a][0];
+                        dy = DungeonMDP::DIRECTIONS[a][1];
+                    }
+                    if (move(state.getPlayerX() + dx, state.getPlayerY() + dy)) out.moves++;
+                }
+            }
+            else {
+                for (size_t i = 1; i < path.size() && !state.isGameOver(); i++) {
+                    if (move(path[i].first, path[i].second)) out.moves++;
+                }
+            }
+            auto t2 = std::chrono::steady_clock::now();
+
+            out.gold = state.getGold();
+            out.reachedExit = state.isGameOver();
+            out.won = out.reachedExit && state.hasMetRewardRequirement();
+            stats.planSeconds += std::chrono::duration<double>(t1 - t0).count();
+            stats.moveSeconds += std::chrono::duration<double>(t2 - t1).count();
+            return out;
+        }
+
+        EngineStats run() const {
+            auto start = std::chrono::steady_clock::now();
+            int threads = options.journal ? 1 : std::max(1, options.threads);
+            std::vector<EngineStats> partial(threads);
+
+            auto worker = [&](int t) {
+                std::uint64_t begin = options.games * t / threads;
+                std::uint64_t end = options.games * (t + 1) / threads;
+                for (std::uint64_t g = begin; g < end; g++)
+                    partial[t].add(playGame(g, partial[t]));
+            };
+
+            std::vector<std::thread> pool;
+            for (int t = 1; t < threads; t++) pool.emplace_back(worker, t);
+            worker(0);
+            for (auto& th : pool) th.join();
+
+            EngineStats total;
+            for (const auto& p : partial) total.merge(p);
+            total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return total;
+        }
+    };
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include "GridView.h"
+#include "Algorithms.h"
+
+// Monte Carlo evaluation of a fixed path under the real game rules:
+// tiles are consumed when stepped on, and every mine asks a question that succeeds
+// with mineSuccessProbability (failure costs 5 gold). Episodes are spread over
+// threads, and each episode draws from its own counter-based stream keyed by the
+// episode index, so results do not depend on the thread count.
+namespace DungeonRollout {
+
+    struct RolloutOptions {
+        std::uint64_t episodes = 1000000;
+        std::uint64_t seed = 0x9E3779B97F4A7C15ull;
+        int threads = 0;                // 0 = hardware concurrency
+        int maxSteps = 0;               // 0 = 4 * cell count
+        int startGold = 0;
+        double mineSuccessProbability = DungeonMDP::MINE_SUCCESS_PROBABILITY;
+    };
+
+    struct RolloutStats {
+        std::uint64_t episodes = 0;
+        std::uint64_t wins = 0;             // reached the exit with enough gold
+        std::uint64_t poorExits = 0;        // reached the exit without enough gold
+        std::uint64_t stuck = 0;            // ran out of steps or walked off the plan
+        double winRate = 0.0;
+        double meanGold = 0.0;
+        std::vector<std::uint64_t> goldHistogram;   // final gold, last bucket is "or more"
+        int goldP50 = 0, goldP90 = 0;
+        int stepsP50 = 0, stepsP90 = 0, stepsP99 = 0;
+        double seconds = 0.0;
+    };
+
+    constexpr int GOLD_BUCKETS = 256;
+
+    // Stateless counter-based generator: the n-th draw of a stream is a pure
+    // function of (seed, stream, n).
+    inline std::uint64_t mix64(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    struct CounterRng {
+        std::uint64_t key;
+        std::uint64_t counter = 0;
+
+        CounterRng(std::uint64_t seed, std::uint64_t stream) : key(mix64(seed ^ mix64(stream))) {}
+
+        double uniform() {
+            return (mix64(key + 0x9E3779B97F4A7C15ull * ++counter) >> 11) * 0x1.0p-53;
+        }
+    };
+
+    namespace detail {
+
+        struct Tally {
+            std::uint64_t wins = 0, poorExits = 0, stuck = 0;
+            std::uint64_t goldSum = 0;
+            std::vector<std::uint64_t> gold;
+            std::vector<std::uint64_t> steps;
+
+            explicit Tally(int maxSteps) : gold(GOLD_BUCKETS, 0), steps(maxSteps + 1, 0) {}
+
+            void merge(const Tally& o) {
+                wins += o.wins; poorExits += o.poorExits; stuck += o.stuck; goldSum += o.goldSum;
+                for (size_t i = 0; i < gold.size(); i++) gold[i] += o.gold[i];
+                for (size_t i = 0; i < steps.size(); i++) steps[i] += o.steps[i];
+            }
+        };
+
+        inline int percentile(const std::vector<std::uint64_t>& hist, std::uint64_t total, double q) {
+            if (total == 0) return 0;
+            std::uint64_t target = (std::uint64_t)(q * (double)(total - 1));
+            std::uint64_t seen = 0;
+            for (size_t i = 0; i < hist.size(); i++) {
+                seen += hist[i];
+                if (seen > target) return (int)i;
+            }
+            return (int)hist.size() - 1;
+        }
+
+        // nextMove(x, y, gold, step, nx, ny) picks the next cell or returns false to stop.
+        template <typename NextMove>
+        RolloutStats run(const GridView& grid, std::pair<int, int> start, const RolloutOptions& options, NextMove nextMove) {
+            auto t0 = std::chrono::steady_clock::now();
+            const int maxSteps = options.maxSteps > 0 ? options.maxSteps : (int)std::min<size_t>(grid.cellCount() * 4, 1 << 20);
+
+            int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+            threads = std::max(1, std::min<int>(threads, (int)std::max<std::uint64_t>(1, options.episodes / 1024)));
+
+            std::vector<Tally> tallies(threads, Tally(maxSteps));
+            auto worker = [&](int t) {
+                Tally& tally = tallies[t];
+                // Consumed tiles are stamped with the episode number, so nothing is cleared between episodes.
+                std::vector<std::uint64_t> consumed(grid.cellCount(), 0);
+                std::uint64_t begin = options.episodes * t / threads;
+                std::uint64_t end = options.episodes * (t + 1) / threads;
+
+                for (std::uint64_t e = begin; e < end; e++) {
+                    CounterRng rng(options.seed, e);
+                    std::uint64_t stamp = e + 1;
+                    int x = start.first, y = start.second;
+                    int gold = options.startGold;
+                    int steps = 0;
+                    bool exited = false;
+
+                    while (steps < maxSteps) {
+                        int nx, ny;
+                        if (!nextMove(x, y, gold, steps, nx, ny) || !grid.contains(nx, ny)) break;
+                        x = nx; y = ny; steps++;
+
+                        size_t c = (size_t)x * grid.height + y;
+                        int cell = consumed[c] == stamp ? 0 : grid.at(x, y);
+                        if (cell == 2) { gold += 10; consumed[c] = stamp; }
+                        else if (cell == 3) { gold /= 2; consumed[c] = stamp; }
+                        else if (cell == 4) {
+                            if (rng.uniform() >= options.mineSuccessProbability) gold = std::max(0, gold - 5);
+                            consumed[c] = stamp;
+                        }
+                        else if (cell == 5) { exited = true; break; }
+                    }
+
+                    if (!exited) tally.stuck++;
+                    else if (gold >= DungeonMDP::MIN_GOLD_FOR_WIN) tally.wins++;
+                    else tally.poorExits++;
+                    tally.goldSum += gold;
+                    tally.gold[std::min(gold, GOLD_BUCKETS - 1)]++;
+                    tally.steps[steps]++;
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (int t = 1; t < threads; t++) pool.emplace_back(worker, t);
+            worker(0);
+            for (auto& th : pool) th.join();
+            for (int t = 1; t < threads; t++) tallies[0].merge(tallies[t]);
+
+            const Tally& all = tallies[0];
+            RolloutStats stats;
+            stats.episodes = options.episodes;
+            stats.wins = all.wins;
+            stats.poorExits = all.poorExits;
+            stats.stuck = all.stuck;
+            if (options.episodes > 0) {
+                stats.winRate = (double)all.wins / (double)options.episodes;
+                stats.meanGold = (double)all.goldSum / (double)options.episodes;
+            }
+            stats.goldHistogram = all.gold;
+            stats.goldP50 = percentile(all.gold, options.episodes, 0.50);
+            stats.goldP90 = percentile(all.gold, options.episodes, 0.90);
+            stats.stepsP50 = percentile(all.steps, options.episodes, 0.50);
+            stats.stepsP90 = percentile(all.steps, options.episodes, 0.90);
+            stats.stepsP99 = percentile(all.steps, options.episodes, 0.99);
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            return stats;
+        }
+    }
+
+    // Follows a planner's path (start cell first) exactly as given; mine outcomes
+    // are the only source of randomness.
+    inline RolloutStats evaluatePath(const GridView& grid, const std::vector<std::pair<int, int>>& path,
+        const RolloutOptions& options = RolloutOptions()) {
+        if (path.empty()) {
+            RolloutStats stats;
+            stats.episodes = stats.stuck = options.episodes;
+            return stats;
+        }
+        RolloutOptions opts = options;
+        opts.maxSteps = (int)path.size() - 1;
+        return detail::run(grid, path.front(), opts,
+            [&path](int, int, int, int step, int& nx, int& ny) {
+                if (step + 1 >= (int)path.size()) return false;
+                nx = path[step + 1].first;
+                ny = path[step + 1].second;
+                return true;
+            });
+    }
+}
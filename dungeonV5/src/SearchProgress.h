@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Shared by a search running on a worker thread and the thread that started it.
+// The search publishes how far it got and polls for cancellation once per expanded
+// node (or per MDP sweep); any thread may read the counters or cancel.
+struct SearchProgress {
+    std::atomic<bool> cancelled{ false };
+    std::atomic<std::uint32_t> expanded{ 0 };      // nodes taken off the frontier
+    std::atomic<std::uint32_t> sweeps{ 0 };        // MDP value-iteration sweeps
+    std::atomic<double> residual{ 0.0 };           // max |V' - V| of the last sweep
+
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    // Counts one expansion; true means stop.
+    bool expand() {
+        expanded.fetch_add(1, std::memory_order_relaxed);
+        return isCancelled();
+    }
+
+    bool sweep(double maxDelta) {
+        residual.store(maxDelta, std::memory_order_relaxed);
+        sweeps.fetch_add(1, std::memory_order_relaxed);
+        return isCancelled();
+    }
+};
@@ -14,29 +14,98 @@
 #include <ctime>
 #include <iostream>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <cstdint>
+#include <initializer_list>
 #include "Algorithms.h"
+#include "SearchProgress.h"
+#include "Rollout.h"
+#include "Tournament.h"
 #include "GameState.h"
+#include "GameJournal.h"
+#include "FrameProfiler.h"
+#include "DungeonViewport.h"
 #include "QuestionsPopUp.h"
 
 class SimulationCanvas : public gui::Canvas {
 private:
     enum class AlgorithmType { None, BFS, DFS, DIJKSTRA, AStar, Greedy, MDP };
+    std::uint32_t gameSeed;
     std::mt19937 rng;
     GameState gameState;
+    // Filled by movePlayer, handled right after the move by handleGameEvents.
+    GameState::EventQueue gameEvents;
+    // Enabled by setting DUNGEON_JOURNAL to a file path; replay with dungeonSim --replay.
+    DungeonJournal::JournalWriter journal;
 
     gui::CoordType leftZoneLeft = 0, leftZoneTop = 0, leftZoneWidth = 0;
     gui::CoordType rightZoneLeft = 0, rightZoneTop = 0, rightZoneWidth = 0;
+    gui::Size canvasSize;
 
     gui::Image imgPlayer, imgReward, imgBandit, imgMine, imgExit, imgBackground;
     gui::Sound sndReward, sndMine, sndBandit, sndExit, sndNoExit, sndSoundtrack;
 
     bool imagesLoaded = true, backgroundLoaded = true, soundtrackPlaying = false;
+    // Tile sprites indexed by cell type, nullptr where a type has none.
+    gui::Image* sprites[GameState::EXIT + 1] = {};
 
     bool algorithmRunning = false;
     int  currentAlgorithm = 0;
-    long long algorithmExecTimeUs = 0;
-    std::vector<std::pair<int, int>> fullAlgorithmPath;
-    std::vector<std::pair<int, int>> fullExploredNodes;
+    static constexpr std::uint64_t ROLLOUT_EPISODES = 200000;
+
+    // Everything the panel shows for one algorithm on the current dungeon.
+    struct AlgorithmRun {
+        AlgorithmType type = AlgorithmType::None;
+        int startGold = 0;
+        long long execTimeUs = 0;
+        DungeonAlgorithms::SearchResult result;
+        DungeonRollout::RolloutStats rollout;
+        DungeonMDP::MDPResult mdp;
+    };
+    std::shared_ptr<const AlgorithmRun> activeRun = std::make_shared<AlgorithmRun>();
+
+    // Results for all six algorithms on the current dungeon, filled in the background:
+    // the five searches when the dungeon is generated, MDP once the game is won and the
+    // final gold is known. cacheGeneration changes with the dungeon, so a worker still
+    // busy with the old one stops and its results are dropped.
+    std::shared_ptr<const AlgorithmRun> runCache[6];
+    std::mutex cacheMutex;
+    std::thread precomputeThread;
+    std::shared_ptr<SearchProgress> precomputeProgress;
+    std::atomic<std::uint64_t> cacheGeneration{ 0 };
+    int pendingMdpGold = -1;            // MDP solve handed to the worker; guarded by cacheMutex
+    bool precomputeIdle = true;         // worker has returned or is returning; guarded by cacheMutex
+
+    // A selected algorithm whose result is not cached yet. It is solved on a worker so
+    // the window stays responsive; onDraw shows its progress and picks up the result.
+    // Selecting another algorithm or generating a dungeon cancels it.
+    struct SolveJob {
+        AlgorithmType type = AlgorithmType::None;
+        int gold = 0;
+        SearchProgress progress;
+        std::shared_ptr<const AlgorithmRun> run;    // written by the worker before done
+        std::atomic<bool> done{ false };
+        std::thread thread;
+    };
+    std::unique_ptr<SolveJob> solveJob;
+    DungeonTournament::TournamentResult tournament;
+    bool tournamentReady = false, showTournament = false;
+
+    // The tournament runs on a worker in the same way as SolveJob; the table shows its
+    // progress until onDraw picks up the result.
+    struct TournamentJob {
+        DungeonTournament::TournamentOptions options;
+        SearchProgress progress;
+        DungeonTournament::TournamentResult result;     // written by the worker before done
+        std::atomic<bool> done{ false };
+        std::thread thread;
+    };
+    std::unique_ptr<TournamentJob> tournamentJob;
+    const std::uint64_t TOURNAMENT_DUNGEONS = 200;
 
     bool isAnimating = false;
     int  animationPhase = 0, currentExploredIndex = 0, currentPathIndex = 0;
@@ -48,10 +117,211 @@ private:
     bool dropdownExpanded = false, speedControlExpanded = false;
 
     int displayGrid[GameState::GRID_SIZE][GameState::GRID_SIZE];
+    // What displayGrid currently shows, so updateVisualization only applies new cells.
+    const AlgorithmRun* shownRun = nullptr;
+    int shownExplored = 0, shownPath = 0;
+    bool shownExploredNodes = true;
+
+    // Cell types of one drawn layer plus a compact list of the non-empty cells,
+    // maintained per changed cell, so drawing visits only occupied cells.
+    struct CellLayer {
+        static const int CELLS = GameState::GRID_SIZE * GameState::GRID_SIZE;
+        int type[CELLS];
+        std::int16_t slot[CELLS];           // position in occupied, -1 if empty
+        std::uint16_t occupied[CELLS];
+        int count = 0;
+
+        CellLayer() {
+            for (int i = 0; i < CELLS; i++) { type[i] = GameState::EMPTY; slot[i] = -1; }
+        }
+
+        void set(int cell, int t) {
+            if (type[cell] == t) return;
+            type[cell] = t;
+            if (t != GameState::EMPTY && slot[cell] < 0) {
+                slot[cell] = (std::int16_t)count;
+                occupied[count++] = (std::uint16_t)cell;
+            }
+            else if (t == GameState::EMPTY && slot[cell] >= 0) {
+                int last = occupied[--count];
+                occupied[slot[cell]] = (std::uint16_t)last;
+                slot[last] = slot[cell];
+                slot[cell] = -1;
+            }
+        }
+    };
+    CellLayer boardLayer;       // game board, refreshed from GameState's dirty cells
+    CellLayer visualLayer;      // algorithm visualization (displayGrid)
+
+    // Grid geometry and the shapes that depend only on it (background fallback,
+    // lines, animation border). Rebuilt on resize or a new dungeon, not per frame.
+    struct GridLayer {
+        bool valid = false;
+        unsigned generation = 0;    // bumped on every rebuild; keys the per-cell shapes
+        gui::CoordType startX = 0, startY = 0, gridSize = 0, cellSize = 0;
+        gui::Rect bounds;
+        gui::Shape background, border;
+        gui::Shape lines[2 * (GameState::GRID_SIZE + 1)];
+    };
+    GridLayer gridLayer;
+
+    // Per-cell overlay and fallback shapes, built on first use and kept until the
+    // grid geometry changes.
+    struct CellShapes {
+        unsigned generation = 0;    // gridLayer.generation they were built for
+        gui::Shape explored[2];
+        gui::Shape path[4];
+        gui::Shape tile;
+        gui::Rect sprite;           // destination rect of the tile sprite
+    };
+    CellShapes cellShapes[CellLayer::CELLS];
+
+    // A panel shape that is rebuilt only when its rect (or radius) changes.
+    struct CachedShape {
+        gui::Shape shape;
+        gui::Rect rect;
+        gui::CoordType radius = -1;     // -1 = not built, 0 = plain rect
+
+        const gui::Shape& get(const gui::Rect& r, gui::CoordType rounding) {
+            if (radius != rounding || r.left != rect.left || r.top != rect.top || r.right != rect.right || r.bottom != rect.bottom) {
+                if (rounding > 0) shape.createRoundedRect(r, rounding);
+                else shape.createRect(r);
+                rect = r;
+                radius = rounding;
+            }
+            return shape;
+        }
+
+        void invalidate() { radius = -1; }
+    };
+    enum PanelShape { SHAPE_FRAME, SHAPE_SPEED_BUTTON, SHAPE_SLIDER_TRACK, SHAPE_SLIDER_FILL, SHAPE_SLIDER_HANDLE,
+        SHAPE_DROPDOWN, SHAPE_DROPDOWN_MENU, SHAPE_DROPDOWN_HIGHLIGHT, SHAPE_STATISTICS, SHAPE_TABLE,
+        SHAPE_BUTTON_START, SHAPE_BUTTON_PAUSE, SHAPE_BUTTON_STEP, SHAPE_BUTTON_RESET, SHAPE_BUTTON_GENERATE,
+        SHAPE_BUTTON_TOURNAMENT, SHAPE_INSPECT_VIEW, SHAPE_RACE_VIEW, NUM_PANEL_SHAPES };
+    CachedShape panelShapes[NUM_PANEL_SHAPES];
+
+    // Large-dungeon inspection, toggled with L: an INSPECT_SIZE^2 generated dungeon in
+    // place of the board, seen through a camera (drag or arrows to pan, wheel or +/- to
+    // zoom, F to fit). Only visible cells are drawn, and once cells shrink below
+    // LOD_MIN_PX each block of cells is drawn as one colour from the tile pyramid.
+    // The map is generated on a worker the first time L is pressed; the view shows
+    // "Building…" until onDraw sees it done.
+    static constexpr int INSPECT_SIZE = 4096;
+    static constexpr double LOD_MIN_PX = 4.0;
+    bool inspecting = false, cameraFitted = false, dragging = false;
+    struct InspectMap {
+        DungeonGen::Dungeon dungeon;            // written by the worker before done
+        DungeonView::TilePyramid pyramid;       // points into dungeon, so the map never moves
+        std::atomic<bool> done{ false };
+        std::thread thread;
+    };
+    std::unique_ptr<InspectMap> inspectMap;
+    DungeonView::Camera camera;
+    gui::Point dragLast;
+
+    // Algorithm race, toggled with R once the game is over: all six algorithms solve the
+    // current layout on their own workers, then play back together in a 2x3 grid of
+    // mini-maps, one step per animationSpeed ms on a single clock. The static tiles are
+    // built once and copied into every lane, which then only applies its own explored
+    // and path cells; each mini-map's shapes are kept until the grid geometry changes.
+    struct RaceLane {
+        AlgorithmType type = AlgorithmType::None;
+        SearchProgress progress;
+        std::shared_ptr<const AlgorithmRun> run;    // written by the worker before done
+        std::atomic<bool> done{ false };
+        std::thread thread;
+
+        CellLayer layer;                // static tiles plus the cells revealed so far
+        int shownExplored = 0, shownPath = 0;
+        long long totalSteps = 0;       // explored nodes, the switch to the path, path cells
+        int rank = 0;                   // finishing place, shown once the lane is done
+
+        unsigned generation = 0;        // gridLayer.generation the shapes were built for
+        gui::Rect bounds, labelRect, counterRect;
+        gui::Shape background, border;
+        gui::Shape cells[CellLayer::CELLS];
+    };
+    struct Race {
+        RaceLane lanes[6];
+        CellLayer tiles;                // shared static tiles of the raced layout
+        bool started = false;           // every lane solved and the clock running
+        long long steps = 0;            // steps played so far on the shared clock
+        int finished = 0;
+        std::chrono::steady_clock::time_point clock;
+    };
+    std::unique_ptr<Race> race;
+    static constexpr int RACE_COLUMNS = 3, RACE_ROWS = 2;
+
+    // Frame timing HUD, toggled with P; O starts and stops a CSV dump of every frame.
+    FrameProfiler profiler;
+
+    const gui::Shape& panelShape(int slot, const gui::Rect& r, gui::CoordType rounding) {
+        profiler.countShapes(1);
+        return panelShapes[slot].get(r, rounding);
+    }
+
+    template <typename... Args>
+    void drawText(Args&&... args) {
+        profiler.countStrings(1);
+        gui::DrawableString::draw(std::forward<Args>(args)...);
+    }
+
+    // Panel text that persists between frames. A slot re-formats its string only when
+    // its key changes: the shown values hashed with textKey, or the address of a literal.
+    struct CachedText {
+        gui::DrawableString text;
+        std::uint64_t key = 0;
+        bool valid = false;
+    };
+
+    enum TextSlot {
+        TEXT_SELECT_LABEL, TEXT_SPEED, TEXT_FAST, TEXT_SLOW, TEXT_DROPDOWN, TEXT_DROPDOWN_ARROW,
+        TEXT_OPTIONS, TEXT_GOLD_LABEL = TEXT_OPTIONS + 6, TEXT_GOLD, TEXT_STATUS_LABEL, TEXT_STATUS,
+        TEXT_PATH_LABEL, TEXT_PATH, TEXT_EXPLORED_LABEL, TEXT_EXPLORED,
+        TEXT_BUTTONS, TEXT_TABLE_TITLE = TEXT_BUTTONS + 6, TEXT_TABLE_HINT,
+        TEXT_DETAILS, TEXT_TOURNAMENT = TEXT_DETAILS + 8,
+        TEXT_RACE = TEXT_TOURNAMENT + 1 + 7 + DungeonTournament::NUM_ALGORITHMS * 7,    // title, headers, name + six values per row
+        NUM_TEXT_SLOTS = TEXT_RACE + 2 * 6                                              // name and counter per lane
+    };
+    CachedText texts[NUM_TEXT_SLOTS];
+
+    static std::uint64_t textKey(std::initializer_list<double> values) {
+        std::uint64_t h = 1469598103934665603ull;
+        for (double v : values) {
+            std::uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            h = (h ^ bits) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    template <typename Format>
+    void drawCachedText(int slot, std::uint64_t key, Format&& format, const gui::Rect& r, gui::Font::ID font,
+        td::ColorID color, td::TextAlignment align, td::VAlignment valign) {
+        CachedText& t = texts[slot];
+        if (!t.valid || t.key != key) {
+            t.text = format().c_str();
+            t.key = key;
+            t.valid = true;
+        }
+        profiler.countStrings(1);
+        t.text.draw(r, font, color, align, valign);
+    }
+
+    void drawLabel(int slot, const char* label, const gui::Rect& r, gui::Font::ID font,
+        td::ColorID color, td::TextAlignment align, td::VAlignment valign) {
+        drawCachedText(slot, (std::uint64_t)(std::uintptr_t)label, [label] { return std::string(label); }, r, font, color, align, valign);
+    }
+
+    void invalidateLayout() {
+        gridLayer.valid = false;
+        for (CachedShape& c : panelShapes) c.invalidate();
+        for (CachedText& t : texts) t.valid = false;
+    }
 
     gui::Rect dropdownRect, dropdownItemRects[6];
     gui::Rect speedButtonRect, speedSliderRect;
-    gui::Rect startButtonRect, pauseButtonRect, stepButtonRect, resetButtonRect, generateNewGameRect;
+    gui::Rect startButtonRect, pauseButtonRect, stepButtonRect, resetButtonRect, generateNewGameRect, tournamentButtonRect;
 
     struct PendingMineEvent {
         bool pending = false;
@@ -59,13 +329,6 @@ private:
     };
     PendingMineEvent pendingMine;
 
-    struct PendingMineResult {
-        bool pending = false;
-        bool wasCorrect = false;
-        int  value = 0;
-    };
-    PendingMineResult pendingMineResult;
-
     static const char* algorithmName(AlgorithmType type) {
         if (type == AlgorithmType::BFS)    return "BFS";
         if (type == AlgorithmType::DFS)    return "DFS";
@@ -76,6 +339,7 @@ private:
         return "";
     }
 
+    // Full rebuild of displayGrid: the initial layout with nothing revealed yet.
     void setupAlgorithmVisualization() {
         const auto& s = gameState.getInitialState();
         for (int i = 0; i < GameState::GRID_SIZE; i++)
@@ -83,37 +347,53 @@ private:
                 displayGrid[i][j] = s.actualGrid[i][j];
         displayGrid[s.playerStartX][s.playerStartY] = GameState::PLAYER;
         displayGrid[s.exitX][s.exitY] = GameState::EXIT;
+        syncVisualLayer();
+
+        shownRun = activeRun.get();
+        shownExplored = 0;
+        shownPath = 0;
+        shownExploredNodes = showExploredNodes;
         reDraw();
     }
 
+    void setVisualCell(int x, int y, int type) {
+        displayGrid[x][y] = type;
+        visualLayer.set(x * GameState::GRID_SIZE + y, type);
+    }
+
+    // Applies only the explored and path cells revealed since the last call. Stepping
+    // backwards, a different run or toggling explored nodes falls back to a full rebuild.
     void updateVisualization() {
-        const auto& s = gameState.getInitialState();
-        for (int i = 0; i < GameState::GRID_SIZE; i++)
-            for (int j = 0; j < GameState::GRID_SIZE; j++)
-                displayGrid[i][j] = s.actualGrid[i][j];
+        if (shownRun != activeRun.get() || shownExploredNodes != showExploredNodes
+            || currentExploredIndex < shownExplored || currentPathIndex < shownPath)
+            setupAlgorithmVisualization();
 
+        const auto& s = gameState.getInitialState();
+        const auto& explored = activeRun->result.exploredNodes;
+        int exploredEnd = std::min(currentExploredIndex, (int)explored.size());
         if (showExploredNodes) {
-            for (int i = 0; i < currentExploredIndex && i < (int)fullExploredNodes.size(); i++) {
-                int x = fullExploredNodes[i].first;
-                int y = fullExploredNodes[i].second;
+            for (int i = shownExplored; i < exploredEnd; i++) {
+                int x = explored[i].first;
+                int y = explored[i].second;
                 if (x == s.playerStartX && y == s.playerStartY) continue;
                 if (x == s.exitX && y == s.exitY) continue;
                 int cell = s.actualGrid[x][y];
-                if (cell < GameState::REWARD || cell > GameState::MINE)
-                    displayGrid[x][y] = GameState::EXPLORED_NODE;
+                if ((cell < GameState::REWARD || cell > GameState::MINE) && displayGrid[x][y] != GameState::PATH_VISUAL)
+                    setVisualCell(x, y, GameState::EXPLORED_NODE);
             }
         }
+        shownExplored = std::max(shownExplored, exploredEnd);
 
-        for (int i = 0; i < currentPathIndex && i < (int)fullAlgorithmPath.size(); i++) {
-            int x = fullAlgorithmPath[i].first;
-            int y = fullAlgorithmPath[i].second;
+        const auto& path = activeRun->result.path;
+        int pathEnd = std::min(currentPathIndex, (int)path.size());
+        for (int i = shownPath; i < pathEnd; i++) {
+            int x = path[i].first;
+            int y = path[i].second;
             if (x == s.playerStartX && y == s.playerStartY) continue;
             if (x == s.exitX && y == s.exitY) continue;
-            displayGrid[x][y] = GameState::PATH_VISUAL;
+            setVisualCell(x, y, GameState::PATH_VISUAL);
         }
-
-        displayGrid[s.playerStartX][s.playerStartY] = GameState::PLAYER;
-        displayGrid[s.exitX][s.exitY] = GameState::EXIT;
+        shownPath = std::max(shownPath, pathEnd);
     }
 
     void resetGame() {
@@ -126,23 +406,31 @@ private:
             td::String message;
             message.format("You only had %d gold (need 20). Try again!", gameState.getGold());
             showAlert("Insufficient Gold!", message);
+            journal.resetPosition();
             gameState.resetPlayerPosition();
             reDraw();
             return;
         }
 
-        rng = std::mt19937(std::random_device{}());
+        stopRace();
+        cancelSolveJob();
+        stopPrecompute();
+        for (auto& run : runCache) run.reset();
+
+        gameSeed = std::random_device{}();
+        rng.seed(gameSeed);
         gameState = GameState(rng);
-        gameState.setGameEventCallback([this](const std::string& event, int value) {
-            handleGameEvent(event, value);
-            });
+        journal.newGame(gameSeed, gameState.getInitialState().layoutHash);
+        gameEvents.clear();
+        gameState.setEventQueue(&gameEvents);
+        gridLayer.valid = false;
+        startPrecompute();
 
         algorithmRunning = false;
         isAnimating = false;
+        stopAnimationIfIdle();
         currentAlgorithm = 0;
-        algorithmExecTimeUs = 0;
-        fullAlgorithmPath.clear();
-        fullExploredNodes.clear();
+        activeRun = std::make_shared<AlgorithmRun>();
         currentExploredIndex = 0;
         currentPathIndex = 0;
         animationPhase = 0;
@@ -151,43 +439,48 @@ private:
         soundtrackPlaying = false;
         pendingMine.pending = false;
         pendingMine.value = 0;
-        pendingMineResult.pending = false;
 
         reDraw();
     }
 
-    void handleGameEvent(const std::string& event, int value) {
-        if (event == "mine") {
+    // Handles what the last move caused, right after it and before the repaint it asks
+    // for, so onDraw only ever draws settled state.
+    void handleGameEvents() {
+        gameEvents.drain([this](const GameState::Event& event) { handleGameEvent(event); });
+        processPendingMine();
+    }
+
+    void handleGameEvent(const GameState::Event& event) {
+        td::String message;
+        switch (event.type) {
+        case GameState::EventType::Mine:
             sndMine.play();
             pendingMine.pending = true;
-            pendingMine.value = value;
-            reDraw();
-        }
-        else if (event == "reward") {
+            pendingMine.value = event.value;
+            break;
+        case GameState::EventType::Reward:
             sndReward.play();
-            td::String message;
-            message.format("You found %d gold!\nTotal gold: %d", value, gameState.getGold());
+            message.format("You found %d gold!\nTotal gold: %d", event.value, gameState.getGold());
             gui::Alert::show("Reward Found!", message);
-        }
-        else if (event == "bandit") {
+            break;
+        case GameState::EventType::Bandit:
             sndBandit.play();
-            td::String message;
             message.format("A bandit stole half your gold!\nRemaining gold: %d", gameState.getGold());
             gui::Alert::show("Bandit Attack!", message);
-        }
-        else if (event == "exit") {
+            break;
+        case GameState::EventType::Exit:
+            precomputeMdp(gameState.getGold());
             sndExit.play();
-            td::String message;
             message.format("You escaped the dungeon!\nFinal gold: %d", gameState.getGold());
             gui::Alert::show("You Win!", message);
-        }
-        else if (event == "exit_insufficient") {
+            break;
+        case GameState::EventType::ExitInsufficient:
             sndNoExit.play();
-            td::String message;
-            message.format("You only had %d gold (need 20).\nThe dungeon will reset - try again!", value);
+            message.format("You only had %d gold (need 20).\nThe dungeon will reset - try again!", event.value);
             gui::Alert::show("Cannot Generate New Dungeon", message);
+            journal.resetPosition();
             gameState.resetPlayerPosition();
-            reDraw();
+            break;
         }
     }
 
@@ -201,19 +494,13 @@ private:
         DialogLogin* dlg = DialogLogin::createWithRandomQuestion(this);
         dlg->openModal([this, value](gui::Dialog* pDlg) {
             DialogLogin* q = (DialogLogin*)pDlg;
-            pendingMineResult.pending = true;
-            pendingMineResult.wasCorrect = q->isAnswerCorrect();
-            pendingMineResult.value = value;
-            reDraw();
+            applyMineAnswer(q->isAnswerCorrect(), value);
             });
     }
 
-    void processPendingMineResult() {
-        if (!pendingMineResult.pending) return;
-
-        bool correct = pendingMineResult.wasCorrect;
-        int  value = pendingMineResult.value;
-        pendingMineResult.pending = false;
+    // Runs from the mine dialog's callback once the question is answered.
+    void applyMineAnswer(bool correct, int value) {
+        journal.mineAnswer(correct);
 
         td::String message;
         if (correct) {
@@ -229,82 +516,470 @@ private:
         reDraw();
     }
 
-    void drawGameGrid() {
+    void rebuildGridLayer() {
         int N = GameState::GRID_SIZE;
         gui::CoordType margin = leftZoneWidth * 0.01;
-        gui::CoordType gridSize = leftZoneWidth - 2 * margin;
-        gui::CoordType cellSize = gridSize / N;
-        gui::CoordType startX = leftZoneLeft + margin;
-        gui::CoordType startY = leftZoneTop + margin;
+        GridLayer& g = gridLayer;
+        g.gridSize = leftZoneWidth - 2 * margin;
+        g.cellSize = g.gridSize / N;
+        g.startX = leftZoneLeft + margin;
+        g.startY = leftZoneTop + margin;
+        g.bounds = gui::Rect(g.startX, g.startY, g.startX + g.gridSize, g.startY + g.gridSize);
+        g.background.createRect(g.bounds);
+        g.border.createRect(g.bounds);
+
+        for (int i = 0; i <= N; i++) {
+            gui::Point pts1[2] = { {g.startX + i * g.cellSize, g.startY}, {g.startX + i * g.cellSize, g.startY + g.gridSize} };
+            g.lines[2 * i].createLines(pts1, 2, 2);
+            gui::Point pts2[2] = { {g.startX, g.startY + i * g.cellSize}, {g.startX + g.gridSize, g.startY + i * g.cellSize} };
+            g.lines[2 * i + 1].createLines(pts2, 2, 2);
+        }
+        g.generation++;
+        g.valid = true;
+    }
+
+    // natGUI has no off-screen target, so the grid layer caches shapes, not pixels: it
+    // saves rebuilding the line, border and per-cell shapes each frame. What is drawn
+    // is bounded by the repaint rect instead. A move repaints only its dirty cells (see
+    // reDrawMove), so the background is redrawn clipped to them and only the lines and
+    // occupied cells inside that rect are drawn. Full repaints (resize, animation
+    // ticks) still draw every occupied cell.
+    void drawGameGrid(const gui::Rect& dirty) {
+        if (!gridLayer.valid) rebuildGridLayer();
+        const GridLayer& g = gridLayer;
+        const int N = GameState::GRID_SIZE;
+        if (!dirty.intersects(g.bounds)) return;
 
         if (backgroundLoaded) {
-            try { imgBackground.draw(gui::Rect(startX, startY, startX + gridSize, startY + gridSize)); }
+            try { imgBackground.draw(g.bounds); }
             catch (...) { backgroundLoaded = false; }
         }
-        if (!backgroundLoaded) {
-            gui::Shape gridBg;
-            gridBg.createRect(gui::Rect(startX, startY, startX + gridSize, startY + gridSize));
-            gridBg.drawFill(td::ColorID::DarkGray);
-        }
+        if (!backgroundLoaded)
+            g.background.drawFill(td::ColorID::DarkGray);
 
+        int shapes = 1 + (isAnimating ? 1 : 0);
         for (int i = 0; i <= N; i++) {
-            gui::Point pts1[2] = { {startX + i * cellSize, startY}, {startX + i * cellSize, startY + gridSize} };
-            gui::Shape line1; line1.createLines(pts1, 2, 2); line1.drawWire(td::ColorID::Gray);
-            gui::Point pts2[2] = { {startX, startY + i * cellSize}, {startX + gridSize, startY + i * cellSize} };
-            gui::Shape line2; line2.createLines(pts2, 2, 2); line2.drawWire(td::ColorID::Gray);
+            gui::CoordType at = i * g.cellSize;
+            if (dirty.intersects(gui::Rect(g.startX + at, g.startY, g.startX + at, g.startY + g.gridSize))) {
+                g.lines[2 * i].drawWire(td::ColorID::Gray);
+                shapes++;
+            }
+            if (dirty.intersects(gui::Rect(g.startX, g.startY + at, g.startX + g.gridSize, g.startY + at))) {
+                g.lines[2 * i + 1].drawWire(td::ColorID::Gray);
+                shapes++;
+            }
+        }
+        profiler.countShapes(shapes);
+
+        const CellLayer& layer = algorithmRunning ? visualLayer : boardLayer;
+        for (int k = 0; k < layer.count; k++) {
+            int cell = layer.occupied[k];
+            gui::CoordType x = g.startX + (cell / N) * g.cellSize;
+            gui::CoordType y = g.startY + (cell % N) * g.cellSize;
+            if (!dirty.intersects(gui::Rect(x, y, x + g.cellSize, y + g.cellSize))) continue;
+            drawCellContent(cell, x, y, g.cellSize, layer.type[cell]);
+        }
+
+        if (isAnimating)
+            g.border.drawWire(td::ColorID::Yellow, 3.0f);
+    }
+
+    static td::ColorID tileColor(int tile) {
+        switch (tile) {
+        case GameState::PLAYER: return td::ColorID::Green;
+        case GameState::REWARD: return td::ColorID::Yellow;
+        case GameState::BANDIT: return td::ColorID::Blue;
+        case GameState::MINE:   return td::ColorID::Red;
+        default:                return td::ColorID::White;
+        }
+    }
+
+    // Fills cells [cx, cx + cw) x [cy, cy + ch) clipped to the view; at least minPx wide.
+    void fillCells(const gui::Rect& view, double cx, double cy, double cw, double ch, double minPx, td::ColorID color) {
+        double l = view.left + (cx - camera.originX) * camera.cellPx;
+        double t = view.top + (cy - camera.originY) * camera.cellPx;
+        double r = l + std::max(minPx, cw * camera.cellPx);
+        double b = t + std::max(minPx, ch * camera.cellPx);
+        if (r <= view.left || b <= view.top || l >= view.right || t >= view.bottom) return;
+        gui::Shape cell;
+        cell.createRect(gui::Rect(std::max<double>(l, view.left), std::max<double>(t, view.top),
+            std::min<double>(r, view.right), std::min<double>(b, view.bottom)));
+        cell.drawFill(color);
+        profiler.countShapes(1);
+    }
+
+    void toggleInspection() {
+        stopRace();
+        inspecting = !inspecting;
+        dragging = false;
+        if (inspecting && !inspectMap) {
+            inspectMap = std::make_unique<InspectMap>();
+            InspectMap* map = inspectMap.get();
+            std::uint32_t seed = gameSeed;
+            map->thread = std::thread([map, seed]() {
+                DungeonGen::GeneratorConfig config;
+                config.width = config.height = INSPECT_SIZE;
+                config.rewardDensity = config.banditDensity = config.mineDensity = 0.01;
+                DungeonGen::DungeonGenerator generator(config);
+                std::mt19937 inspectRng(seed);
+                generator.generate(inspectRng, map->dungeon);
+                map->pyramid.build(map->dungeon);
+                map->done.store(true, std::memory_order_release);
+                });
+            cameraFitted = false;
+            // Keeps onDraw coming until the map is picked up.
+            gui::Canvas::startAnimation();
+        }
+        reDraw();
+    }
+
+    bool inspectMapReady() const { return inspectMap && !inspectMap->thread.joinable(); }
+
+    // Runs from onDraw: joins the worker once the map is built.
+    void pollInspectMap() {
+        if (!inspectMap || !inspectMap->thread.joinable() || !inspectMap->done.load(std::memory_order_acquire)) return;
+        inspectMap->thread.join();
+        cameraFitted = false;
+        stopAnimationIfIdle();
+    }
+
+    void drawInspectView() {
+        if (!gridLayer.valid) rebuildGridLayer();
+        const gui::Rect& view = gridLayer.bounds;
+        panelShape(SHAPE_INSPECT_VIEW, view, 0).drawFill(td::ColorID::Black);
+        if (!inspectMapReady()) {
+            char info[64];
+            snprintf(info, sizeof(info), "Building %d x %d dungeon…", INSPECT_SIZE, INSPECT_SIZE);
+            drawText(info, strlen(info), view, gui::Font::ID::SystemNormal, td::ColorID::LightGray,
+                td::TextAlignment::Center, td::VAlignment::Center);
+            return;
+        }
+
+        const DungeonGen::Dungeon& d = inspectMap->dungeon;
+        const DungeonView::TilePyramid& pyramid = inspectMap->pyramid;
+        double vw = view.width(), vh = view.height();
+        if (!cameraFitted) {
+            camera.fit(d.width, d.height, vw, vh);
+            cameraFitted = true;
+        }
+
+        int level = pyramid.levelFor(camera.cellPx, LOD_MIN_PX);
+        int block = 1 << level;
+        int x0, y0, x1, y1;
+        camera.visibleCells(d.width, d.height, vw, vh, x0, y0, x1, y1);
+        int bx0 = x0 / block, by0 = y0 / block;
+        int bx1 = std::min(pyramid.width(level), (x1 + block - 1) / block);
+        int by1 = std::min(pyramid.height(level), (y1 + block - 1) / block);
+
+        // One shape per run of equal blocks along a row; empty blocks are skipped.
+        for (int by = by0; by < by1; by++) {
+            int bx = bx0;
+            while (bx < bx1) {
+                int tile = pyramid.at(level, bx, by);
+                if (tile == GameState::EMPTY) { bx++; continue; }
+                int end = bx + 1;
+                while (end < bx1 && pyramid.at(level, end, by) == tile) end++;
+                fillCells(view, (double)bx * block, (double)by * block, (double)(end - bx) * block, block, 0.0, tileColor(tile));
+                bx = end;
+            }
+        }
+
+        fillCells(view, d.startX, d.startY, 1, 1, 6.0, td::ColorID::Green);
+        fillCells(view, d.exitX, d.exitY, 1, 1, 6.0, td::ColorID::White);
+
+        char info[128];
+        snprintf(info, sizeof(info), "%d x %d   %.3g px/cell   block 1:%d   %d x %d cells visible",
+            d.width, d.height, camera.cellPx, block, x1 - x0, y1 - y0);
+        drawText(info, strlen(info), gui::Rect(view.left + 8, view.bottom - 26, view.right - 8, view.bottom - 4),
+            gui::Font::ID::SystemSmaller, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Center);
+    }
+
+    bool handleInspectKey(const gui::Key& key) {
+        double step = gridLayer.gridSize * 0.1;
+        double cx = gridLayer.gridSize * 0.5;
+        if (key.isVirtual()) {
+            gui::Key::Virtual k = key.getVirtual();
+            if (k == gui::Key::Virtual::Right) camera.pan(-step, 0);
+            else if (k == gui::Key::Virtual::Left) camera.pan(step, 0);
+            else if (k == gui::Key::Virtual::Up) camera.pan(0, step);
+            else if (k == gui::Key::Virtual::Down) camera.pan(0, -step);
+            else return false;
+        }
+        else if (key.isASCII()) {
+            char ch = key.getChar();
+            if (ch == 'd' || ch == 'D') camera.pan(-step, 0);
+            else if (ch == 'a' || ch == 'A') camera.pan(step, 0);
+            else if (ch == 'w' || ch == 'W') camera.pan(0, step);
+            else if (ch == 's' || ch == 'S') camera.pan(0, -step);
+            else if (ch == '+' || ch == '=') camera.zoomAt(1.25, cx, cx);
+            else if (ch == '-') camera.zoomAt(0.8, cx, cx);
+            else if (ch == 'f' || ch == 'F') cameraFitted = false;
+            else return false;
+        }
+        else return false;
+        reDraw();
+        return true;
+    }
+
+    void toggleRace() {
+        if (race) {
+            stopRace();
+            reDraw();
+            return;
+        }
+        if (!gameState.isGameOver()) {
+            showAlert("Game In Progress", "You must finish the current game first!");
+            return;
+        }
+        cancelSolveJob();
+        if (isAnimating) pauseAnimation();
+        inspecting = false;
+        dragging = false;
+
+        race = std::make_unique<Race>();
+        const GameState::InitialState& s = gameState.getInitialState();
+        const int N = GameState::GRID_SIZE;
+        for (int x = 0; x < N; x++)
+            for (int y = 0; y < N; y++)
+                race->tiles.set(x * N + y, s.actualGrid[x][y]);
+        race->tiles.set(s.playerStartX * N + s.playerStartY, GameState::PLAYER);
+        race->tiles.set(s.exitX * N + s.exitY, GameState::EXIT);
+
+        int gold = gameState.getGold();
+        for (int i = 0; i < 6; i++) {
+            RaceLane* lane = &race->lanes[i];
+            lane->type = static_cast<AlgorithmType>(i + 1);
+            lane->layer = race->tiles;
+            lane->run = cachedRun(lane->type, gold);
+            if (lane->run) {
+                lane->done.store(true, std::memory_order_release);
+                continue;
+            }
+            GameState::InitialState layout = s;
+            lane->thread = std::thread([lane, layout, gold]() {
+                lane->run = computeRun(lane->type, layout, gold, &lane->progress);
+                lane->done.store(true, std::memory_order_release);
+                });
+        }
+        gui::Canvas::startAnimation();
+        reDraw();
+    }
+
+    void stopRace() {
+        if (!race) return;
+        for (RaceLane& lane : race->lanes) {
+            lane.progress.cancel();
+            if (lane.thread.joinable()) lane.thread.join();
+        }
+        race.reset();
+        stopAnimationIfIdle();
+    }
+
+    // Runs from onDraw. Until every lane is solved it only waits; then it plays the
+    // steps due on the shared clock, carrying the remainder like updateAnimation.
+    void updateRace() {
+        Race& r = *race;
+        if (!r.started) {
+            for (RaceLane& lane : r.lanes)
+                if (!lane.done.load(std::memory_order_acquire)) return;
+            for (int i = 0; i < 6; i++) {
+                RaceLane& lane = r.lanes[i];
+                if (!lane.thread.joinable()) continue;
+                lane.thread.join();
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                runCache[i] = lane.run;
+            }
+            for (RaceLane& lane : r.lanes)
+                lane.totalSteps = (long long)lane.run->result.exploredNodes.size() + 1 + (long long)lane.run->result.path.size();
+            for (RaceLane& lane : r.lanes) {
+                lane.rank = 1;
+                for (const RaceLane& other : r.lanes) lane.rank += other.totalSteps < lane.totalSteps;
+            }
+            r.started = true;
+            r.clock = std::chrono::steady_clock::now();
+            return;
+        }
+        if (r.finished == 6) return;
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsedMs = std::chrono::duration<double, std::milli>(now - r.clock).count();
+        long long due = (long long)(elapsedMs / animationSpeed);
+        if (due <= 0) return;
+        r.clock += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>((double)due * animationSpeed));
+        r.steps += due;
+
+        r.finished = 0;
+        for (RaceLane& lane : r.lanes) {
+            advanceRaceLane(lane, r.steps);
+            r.finished += r.steps >= lane.totalSteps;
         }
+        if (r.finished == 6) stopAnimationIfIdle();
+    }
 
-        for (int i = 0; i < N; i++) {
-            for (int j = 0; j < N; j++) {
-                int cellType = algorithmRunning ? displayGrid[i][j] : gameState.getDisplayCell(i, j);
-                if (cellType != GameState::EMPTY)
-                    drawCellContent(startX + i * cellSize, startY + j * cellSize, cellSize, cellType);
+    // Reveals a lane's cells up to `steps` on the same terms as updateVisualization.
+    void advanceRaceLane(RaceLane& lane, long long steps) {
+        const auto& s = gameState.getInitialState();
+        const int N = GameState::GRID_SIZE;
+        const auto& explored = lane.run->result.exploredNodes;
+        const auto& path = lane.run->result.path;
+        int exploredEnd = (int)std::min<long long>(steps, (long long)explored.size());
+        int pathEnd = (int)std::max(0LL, std::min<long long>(steps - (long long)explored.size() - 1, (long long)path.size()));
+
+        for (int i = lane.shownExplored; i < exploredEnd; i++) {
+            int x = explored[i].first, y = explored[i].second;
+            if ((x == s.playerStartX && y == s.playerStartY) || (x == s.exitX && y == s.exitY)) continue;
+            int cell = s.actualGrid[x][y];
+            if ((cell < GameState::REWARD || cell > GameState::MINE) && lane.layer.type[x * N + y] != GameState::PATH_VISUAL)
+                lane.layer.set(x * N + y, GameState::EXPLORED_NODE);
+        }
+        for (int i = lane.shownPath; i < pathEnd; i++) {
+            int x = path[i].first, y = path[i].second;
+            if ((x == s.playerStartX && y == s.playerStartY) || (x == s.exitX && y == s.exitY)) continue;
+            lane.layer.set(x * N + y, GameState::PATH_VISUAL);
+        }
+        lane.shownExplored = std::max(lane.shownExplored, exploredEnd);
+        lane.shownPath = std::max(lane.shownPath, pathEnd);
+    }
+
+    void buildRaceView(RaceLane& lane, int index) {
+        const GridLayer& g = gridLayer;
+        const int N = GameState::GRID_SIZE;
+        gui::CoordType colW = g.gridSize / RACE_COLUMNS, rowH = g.gridSize / RACE_ROWS, lh = 18;
+        gui::CoordType side = std::min(colW - 16, rowH - 2 * lh - 16);
+        gui::CoordType x = g.startX + (index % RACE_COLUMNS) * colW + (colW - side) / 2;
+        gui::CoordType y = g.startY + (index / RACE_COLUMNS) * rowH + 6;
+        lane.bounds = gui::Rect(x, y, x + side, y + side);
+        lane.labelRect = gui::Rect(x, y + side + 2, x + side, y + side + 2 + lh);
+        lane.counterRect = gui::Rect(x, y + side + 2 + lh, x + side, y + side + 2 + 2 * lh);
+        lane.background.createRect(lane.bounds);
+        lane.border.createRect(lane.bounds);
+
+        gui::CoordType cs = side / N, m = std::max<gui::CoordType>(1, cs * 0.08);
+        for (int cell = 0; cell < CellLayer::CELLS; cell++) {
+            gui::CoordType cx = x + (cell / N) * cs, cy = y + (cell % N) * cs;
+            lane.cells[cell].createRect(gui::Rect(cx + m, cy + m, cx + cs - m, cy + cs - m));
+        }
+        lane.generation = g.generation;
+    }
+
+    // Mini-maps are drawn with flat colours: one cached shape per occupied cell.
+    void drawRaceView(const gui::Rect& dirty) {
+        if (!gridLayer.valid) rebuildGridLayer();
+        panelShape(SHAPE_RACE_VIEW, gridLayer.bounds, 0).drawFill(td::ColorID::Black);
+
+        for (int i = 0; i < 6; i++) {
+            RaceLane& lane = race->lanes[i];
+            if (lane.generation != gridLayer.generation) buildRaceView(lane, i);
+            if (!dirty.intersects(gui::Rect(lane.bounds.left, lane.bounds.top, lane.bounds.right, lane.counterRect.bottom))) continue;
+
+            lane.background.drawFill(td::ColorID::DarkGray);
+            const CellLayer& layer = lane.layer;
+            for (int k = 0; k < layer.count; k++) {
+                int cell = layer.occupied[k];
+                int type = layer.type[cell];
+                td::ColorID color = type == GameState::EXPLORED_NODE ? td::ColorID::SkyBlue
+                    : (type == GameState::PATH_VISUAL ? td::ColorID::Orange : tileColor(type));
+                lane.cells[cell].drawFill(color);
             }
+            bool finished = race->started && race->steps >= lane.totalSteps;
+            lane.border.drawWire(finished ? (lane.rank == 1 ? td::ColorID::Yellow : td::ColorID::LightGreen) : td::ColorID::Gray, 2);
+            profiler.countShapes(2 + layer.count);
+
+            drawLabel(TEXT_RACE + 2 * i, algorithmName(lane.type), lane.labelRect,
+                gui::Font::ID::SystemBold, td::ColorID::White, td::TextAlignment::Center, td::VAlignment::Center);
+            drawRaceCounter(lane, TEXT_RACE + 2 * i + 1, finished);
         }
+    }
 
-        if (isAnimating) {
-            gui::Shape border;
-            border.createRect(gui::Rect(startX, startY, startX + gridSize, startY + gridSize));
-            border.drawWire(td::ColorID::Yellow, 3.0f);
+    // Live counters: nodes (or sweeps) while solving, revealed cells during playback.
+    void drawRaceCounter(const RaceLane& lane, int slot, bool finished) {
+        const gui::Rect& r = lane.counterRect;
+        auto drawCounter = [&](std::uint64_t key, auto&& format) {
+            drawCachedText(slot, key, format, r, gui::Font::ID::SystemSmaller, td::ColorID::LightGreen, td::TextAlignment::Center, td::VAlignment::Center);
+        };
+        if (!lane.done.load(std::memory_order_acquire)) {
+            bool mdp = lane.type == AlgorithmType::MDP;
+            unsigned n = mdp ? lane.progress.sweeps.load() : lane.progress.expanded.load();
+            drawCounter(textKey({ 0.0, (double)n }), [mdp, n] {
+                char buf[64];
+                snprintf(buf, sizeof(buf), mdp ? "solving: sweep %u" : "solving: %u nodes", n);
+                return std::string(buf);
+                });
+        }
+        else if (!race->started) {
+            drawCounter(textKey({ 1.0 }), [] { return std::string("solved, waiting"); });
+        }
+        else {
+            int explored = lane.shownExplored, path = lane.shownPath, rank = finished ? lane.rank : 0;
+            size_t exploredTotal = lane.run->result.exploredNodes.size(), pathTotal = lane.run->result.path.size();
+            drawCounter(textKey({ 2.0, (double)explored, (double)path, (double)rank }), [=] {
+                char buf[96];
+                if (rank) snprintf(buf, sizeof(buf), "#%d  %d explored, path %d", rank, explored, path);
+                else snprintf(buf, sizeof(buf), "%d/%zu explored, path %d/%zu", explored, exploredTotal, path, pathTotal);
+                return std::string(buf);
+                });
         }
     }
 
-    void drawCellContent(gui::CoordType x, gui::CoordType y, gui::CoordType size, int cellType) {
+    void syncVisualLayer() {
+        for (int i = 0; i < GameState::GRID_SIZE; i++)
+            for (int j = 0; j < GameState::GRID_SIZE; j++)
+                visualLayer.set(i * GameState::GRID_SIZE + j, displayGrid[i][j]);
+    }
+
+    void syncBoardCells() {
+        const std::uint8_t* cells = gameState.getDirtyCells();
+        for (int i = 0; i < gameState.getDirtyCount(); i++) {
+            int x = GameState::cellX(cells[i]), y = GameState::cellY(cells[i]);
+            boardLayer.set(cells[i], gameState.getDisplayCell(x, y));
+        }
+        gameState.clearDirty();
+    }
+
+    void buildCellShapes(CellShapes& c, gui::CoordType x, gui::CoordType y, gui::CoordType size) {
         gui::CoordType m = size * 0.1;
+        gui::CoordType gw = size * 0.08;
         gui::Rect cellRect(x + m, y + m, x + size - m, y + size - m);
+        c.explored[0].createRect(cellRect);
+        c.explored[1].createRect(gui::Rect(x + m + 2, y + m + 2, x + size - m - 2, y + size - m - 2));
+        c.path[0].createRoundedRect(gui::Rect(x + m - gw, y + m - gw, x + size - m + gw, y + size - m + gw), 4);
+        c.path[1].createRoundedRect(gui::Rect(x + m - gw * 0.5f, y + m - gw * 0.5f, x + size - m + gw * 0.5f, y + size - m + gw * 0.5f), 3);
+        c.path[2].createRoundedRect(cellRect, 2);
+        c.path[3].createRect(gui::Rect(x + m + 3, y + m + 3, x + size - m - 3, y + size - m - 3));
+        c.tile.createRect(cellRect);
+        c.sprite = cellRect;
+        c.generation = gridLayer.generation;
+    }
+
+    void drawCellContent(int cell, gui::CoordType x, gui::CoordType y, gui::CoordType size, int cellType) {
+        CellShapes& c = cellShapes[cell];
+        if (c.generation != gridLayer.generation) buildCellShapes(c, x, y, size);
 
         if (cellType == GameState::EXPLORED_NODE && showExploredNodes) {
-            gui::Shape s1; s1.createRect(cellRect); s1.drawFill(td::ColorID::LightBlue);
-            gui::Shape s2; s2.createRect(gui::Rect(x + m + 2, y + m + 2, x + size - m - 2, y + size - m - 2)); s2.drawFill(td::ColorID::SkyBlue);
+            profiler.countShapes(2);
+            c.explored[0].drawFill(td::ColorID::LightBlue);
+            c.explored[1].drawFill(td::ColorID::SkyBlue);
             return;
         }
 
         if (cellType == GameState::PATH_VISUAL) {
+            profiler.countShapes(4);
             gui::CoordType gw = size * 0.08;
-            gui::Shape g1; g1.createRoundedRect(gui::Rect(x + m - gw, y + m - gw, x + size - m + gw, y + size - m + gw), 4); g1.drawWire(td::ColorID::Yellow, gw);
-            gui::Shape g2; g2.createRoundedRect(gui::Rect(x + m - gw * 0.5f, y + m - gw * 0.5f, x + size - m + gw * 0.5f, y + size - m + gw * 0.5f), 3); g2.drawWire(td::ColorID::Orange, gw * 0.7f);
-            gui::Shape g3; g3.createRoundedRect(cellRect, 2); g3.drawWire(td::ColorID::White, 3);
-            gui::Shape g4; g4.createRect(gui::Rect(x + m + 3, y + m + 3, x + size - m - 3, y + size - m - 3)); g4.drawFill(td::ColorID::LightYellow);
+            c.path[0].drawWire(td::ColorID::Yellow, gw);
+            c.path[1].drawWire(td::ColorID::Orange, gw * 0.7f);
+            c.path[2].drawWire(td::ColorID::White, 3);
+            c.path[3].drawFill(td::ColorID::LightYellow);
             return;
         }
 
+        if (cellType < GameState::PLAYER || cellType > GameState::EXIT) return;
+        profiler.countShapes(1);
         if (imagesLoaded) {
-            try {
-                if (cellType == GameState::PLAYER) { imgPlayer.draw(cellRect); return; }
-                if (cellType == GameState::REWARD) { imgReward.draw(cellRect); return; }
-                if (cellType == GameState::BANDIT) { imgBandit.draw(cellRect); return; }
-                if (cellType == GameState::MINE) { imgMine.draw(cellRect);   return; }
-                if (cellType == GameState::EXIT) { imgExit.draw(cellRect);   return; }
-            }
+            try { sprites[cellType]->draw(c.sprite); return; }
             catch (...) { imagesLoaded = false; }
         }
-
-        gui::Shape shape; shape.createRect(cellRect);
-        if (cellType == GameState::PLAYER) shape.drawFill(td::ColorID::Green);
-        if (cellType == GameState::REWARD) shape.drawFill(td::ColorID::Yellow);
-        if (cellType == GameState::BANDIT) shape.drawFill(td::ColorID::Blue);
-        if (cellType == GameState::MINE)   shape.drawFill(td::ColorID::Red);
-        if (cellType == GameState::EXIT)   shape.drawFill(td::ColorID::White);
+        c.tile.drawFill(tileColor(cellType));
     }
 
     void drawControlPanel() {
@@ -314,7 +989,7 @@ private:
 
         gui::CoordType labelW = w * 0.6;
         gui::CoordType speedW = w * 0.31;
-        gui::DrawableString::draw("Select Algorithm:", 18,
+        drawLabel(TEXT_SELECT_LABEL, "Select Algorithm:",
             gui::Rect(x, y, x + labelW, y + 30),
             gui::Font::ID::SystemNormal, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Center);
         drawSpeedControl(x + labelW + w * 0.09, y, speedW);
@@ -329,18 +1004,60 @@ private:
         drawControlButtons(x, y, w);
         y += 190;
 
+        if (profiler.isEnabled()) profiler.enter(FrameProfiler::PHASE_TABLE);
         drawComparisonTable(x, y, w);
+        if (profiler.isEnabled()) profiler.enter(FrameProfiler::PHASE_PANEL);
         drawAlgorithmDropdown(x, dropdownY, w);
     }
 
+    void drawProfilerHud() {
+        FrameProfiler::Summary s = profiler.summary();
+        gui::CoordType x = gridLayer.bounds.left + 8, y = gridLayer.bounds.top + 8;
+        gui::CoordType w = 300, lh = 18;
+        gui::Shape bg; bg.createRect(gui::Rect(x, y, x + w, y + 6 * lh + 62));
+        bg.drawFill(td::ColorID::Black); bg.drawWire(td::ColorID::Gray, 1);
+
+        char lines[5][128];
+        snprintf(lines[0], sizeof(lines[0]), "FPS %.1f   frame %.2f ms%s", s.fps, s.last.totalMs, profiler.isDumping() ? "   [dump]" : "");
+        snprintf(lines[1], sizeof(lines[1]), "p50 %.2f   p95 %.2f   p99 %.2f ms", s.p50, s.p95, s.p99);
+        snprintf(lines[2], sizeof(lines[2]), "update %.2f   grid %.2f ms", s.meanPhaseMs[FrameProfiler::PHASE_UPDATE], s.meanPhaseMs[FrameProfiler::PHASE_GRID]);
+        snprintf(lines[3], sizeof(lines[3]), "panel %.2f   table %.2f   hud %.2f ms", s.meanPhaseMs[FrameProfiler::PHASE_PANEL],
+            s.meanPhaseMs[FrameProfiler::PHASE_TABLE], s.meanPhaseMs[FrameProfiler::PHASE_HUD]);
+        snprintf(lines[4], sizeof(lines[4]), "shapes %u   strings %u   (%d frames)", s.last.shapes, s.last.strings, s.frames);
+        for (int i = 0; i < 5; i++)
+            drawText(lines[i], strlen(lines[i]), gui::Rect(x + 8, y + 4 + i * lh, x + w - 8, y + 4 + (i + 1) * lh),
+                gui::Font::ID::SystemSmaller, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Center);
+
+        // Frame-time histogram: <1, <2, <4, <8, <16.7, <33.3, >=33.3 ms.
+        gui::CoordType by = y + 5 * lh + 50, bw = (w - 16) / FrameProfiler::NUM_BUCKETS;
+        std::uint32_t peak = 1;
+        for (std::uint32_t b : s.buckets) peak = std::max(peak, b);
+        for (int b = 0; b < FrameProfiler::NUM_BUCKETS; b++) {
+            gui::CoordType bx = x + 8 + b * bw;
+            gui::CoordType h = 40.0 * s.buckets[b] / peak;
+            gui::Shape bar; bar.createRect(gui::Rect(bx + 1, by - h, bx + bw - 1, by));
+            bar.drawFill(b < 4 ? td::ColorID::LightGreen : (b < 5 ? td::ColorID::Yellow : td::ColorID::Red));
+        }
+    }
+
+    void toggleProfilerDump() {
+        if (profiler.isDumping()) { profiler.stopDump(); return; }
+        const char* path = std::getenv("DUNGEON_FRAME_DUMP");
+        if (!profiler.startDump(path ? path : "dungeon_frames.csv"))
+            showAlert("Frame Profiler", "Could not open the frame dump file.");
+        profiler.setEnabled(true);
+    }
+
     void drawSpeedControl(gui::CoordType x, gui::CoordType y, gui::CoordType width) {
         speedButtonRect = gui::Rect(x, y, x + width, y + 24);
-        gui::Shape bg; bg.createRoundedRect(speedButtonRect, 6);
+        const gui::Shape& bg = panelShape(SHAPE_SPEED_BUTTON, speedButtonRect, 6);
         bg.drawFill(td::ColorID::Moss); bg.drawWire(td::ColorID::Copper, 2);
 
-        char text[64];
-        snprintf(text, sizeof(text), "Speed: %d ms  %s", animationSpeed, speedControlExpanded ? "🢐" : "🢒");
-        gui::DrawableString::draw(text, strlen(text), speedButtonRect,
+        drawCachedText(TEXT_SPEED, textKey({ (double)animationSpeed, (double)speedControlExpanded }), [this] {
+            char text[64];
+            snprintf(text, sizeof(text), "Speed: %d ms  %s", animationSpeed, speedControlExpanded ? "🢐" : "🢒");
+            return std::string(text);
+            }, speedButtonRect,
             gui::Font::ID::SystemSmaller, td::ColorID::White, td::TextAlignment::Center, td::VAlignment::Center);
 
         if (speedControlExpanded)
@@ -349,48 +1066,46 @@ private:
 
     void drawSpeedSlider(gui::CoordType x, gui::CoordType y, gui::CoordType w, gui::CoordType h) {
         speedSliderRect = gui::Rect(x, y, x + w, y + h);
-        gui::Shape track; track.createRoundedRect(speedSliderRect, 4);
+        const gui::Shape& track = panelShape(SHAPE_SLIDER_TRACK, speedSliderRect, 4);
         track.drawFill(td::ColorID::DarkGray); track.drawWire(td::ColorID::Copper, 1);
 
         gui::CoordType fillH = (std::min(MAX_SPEED, animationSpeed) * h) / MAX_SPEED;
         if (fillH > 0) {
-            gui::Shape fill; fill.createRoundedRect(gui::Rect(x, y, x + w, y + fillH), 4);
+            const gui::Shape& fill = panelShape(SHAPE_SLIDER_FILL, gui::Rect(x, y, x + w, y + fillH), 4);
             fill.drawFill(td::ColorID::Orange);
         }
 
         gui::CoordType handleY = y + fillH;
-        gui::Shape handle; handle.createRect(gui::Rect(x - 3, handleY - 6, x + w + 3, handleY + 6));
+        const gui::Shape& handle = panelShape(SHAPE_SLIDER_HANDLE, gui::Rect(x - 3, handleY - 6, x + w + 3, handleY + 6), 0);
         handle.drawFill(td::ColorID::White); handle.drawWire(td::ColorID::Copper, 2);
 
-        gui::DrawableString::draw("Fast", 4, gui::Rect(x - 15, y - 25, x + w + 15, y - 3),
+        drawLabel(TEXT_FAST, "Fast", gui::Rect(x - 15, y - 25, x + w + 15, y - 3),
             gui::Font::ID::SystemSmaller, td::ColorID::LightGray, td::TextAlignment::Center, td::VAlignment::Bottom);
-        gui::DrawableString::draw("Slow", 4, gui::Rect(x - 15, y + h + 5, x + w + 15, y + h + 25),
+        drawLabel(TEXT_SLOW, "Slow", gui::Rect(x - 15, y + h + 5, x + w + 15, y + h + 25),
             gui::Font::ID::SystemSmaller, td::ColorID::LightGray, td::TextAlignment::Center, td::VAlignment::Top);
     }
 
     void handleSpeedSliderClick(const gui::Point& click) {
         gui::CoordType h = speedSliderRect.height();
         gui::CoordType cy = std::max<gui::CoordType>(0, std::min(click.y - speedSliderRect.top, h));
-        animationSpeed = std::max(10, (int)((cy * MAX_SPEED) / h));
+        animationSpeed = std::max(1, (int)((cy * MAX_SPEED) / h));
         reDraw();
     }
 
     void drawAlgorithmDropdown(gui::CoordType x, gui::CoordType y, gui::CoordType width) {
         dropdownRect = gui::Rect(x, y, x + width, y + 50);
-        gui::Shape bg; bg.createRoundedRect(dropdownRect, 6); bg.drawFill(td::ColorID::Moss);
-        gui::Shape border; border.createRoundedRect(dropdownRect, 6); border.drawWire(td::ColorID::LightGreen, 2);
+        const gui::Shape& bg = panelShape(SHAPE_DROPDOWN, dropdownRect, 6);
+        bg.drawFill(td::ColorID::Moss); bg.drawWire(td::ColorID::LightGreen, 2);
 
         const char* names[] = { "Select Algorithm...", "Breadth-First Search (BFS)",
             "Depth-First Search (DFS)", "Dijkstra Search",
             "A* Search", "Greedy Best-First Search", "MDP (Markov Decision Process)" };
-        std::string label = names[currentAlgorithm];
-
-        gui::DrawableString::draw(label.c_str(), label.length(),
+        drawLabel(TEXT_DROPDOWN, names[currentAlgorithm],
             gui::Rect(x + 15, y, x + width - 40, y + 50),
             gui::Font::ID::SystemNormal, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Center);
 
         const char* arrow = dropdownExpanded ? "^" : "v";
-        gui::DrawableString::draw(arrow, 1, gui::Rect(x + width - 35, y, x + width - 10, y + 50),
+        drawLabel(TEXT_DROPDOWN_ARROW, arrow, gui::Rect(x + width - 35, y, x + width - 10, y + 50),
             gui::Font::ID::SystemBold, td::ColorID::White, td::TextAlignment::Center, td::VAlignment::Center);
 
         if (dropdownExpanded) {
@@ -400,19 +1115,18 @@ private:
                 "Greedy Best-First Search", "MDP (Markov Decision Process)" };
 
             gui::CoordType itemH = 45;
-            gui::Shape menuBg; menuBg.createRoundedRect(gui::Rect(x, menuY, x + width, menuY + 6 * itemH), 6);
-            menuBg.drawFill(td::ColorID::Moss);
-            gui::Shape menuBorder; menuBorder.createRoundedRect(gui::Rect(x, menuY, x + width, menuY + 6 * itemH), 6);
-            menuBorder.drawWire(td::ColorID::LightGreen, 2);
+            const gui::Shape& menu = panelShape(SHAPE_DROPDOWN_MENU, gui::Rect(x, menuY, x + width, menuY + 6 * itemH), 6);
+            menu.drawFill(td::ColorID::Moss);
+            menu.drawWire(td::ColorID::LightGreen, 2);
 
             for (int i = 0; i < 6; i++) {
                 gui::CoordType iy = menuY + i * itemH;
                 dropdownItemRects[i] = gui::Rect(x, iy, x + width, iy + itemH);
                 if (i + 1 == currentAlgorithm) {
-                    gui::Shape hi; hi.createRect(gui::Rect(x + 3, iy + 2, x + width - 3, iy + itemH - 2));
-                    hi.drawFill(td::ColorID::DarkRed);
+                    panelShape(SHAPE_DROPDOWN_HIGHLIGHT, gui::Rect(x + 3, iy + 2, x + width - 3, iy + itemH - 2), 0)
+                        .drawFill(td::ColorID::DarkRed);
                 }
-                gui::DrawableString::draw(options[i], strlen(options[i]),
+                drawLabel(TEXT_OPTIONS + i, options[i],
                     gui::Rect(x + 15, iy, x + width - 15, iy + itemH),
                     gui::Font::ID::SystemNormal, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Center);
             }
@@ -420,33 +1134,58 @@ private:
     }
 
     void drawStatisticsPanel(gui::CoordType x, gui::CoordType y, gui::CoordType width) {
-        gui::Shape bg; bg.createRoundedRect(gui::Rect(x, y, x + width, y + 150), 6); bg.drawFill(td::ColorID::Moss);
-        gui::Shape border; border.createRoundedRect(gui::Rect(x, y, x + width, y + 150), 6); border.drawWire(td::ColorID::LightGreen, 2);
+        const gui::Shape& bg = panelShape(SHAPE_STATISTICS, gui::Rect(x, y, x + width, y + 150), 6);
+        bg.drawFill(td::ColorID::Moss); bg.drawWire(td::ColorID::LightGreen, 2);
 
         gui::CoordType cy = y + 20;
         gui::CoordType hw = (width - 40) / 2;
 
-        std::string status;
-        if (isAnimating)                 status = "Animating";
+        const char* status;
+        if (race)                        status = race->finished == 6 ? "Race Finished" : "Racing";
+        else if (solveJob)               status = "Solving…";
+        else if (isAnimating)            status = "Animating";
         else if (algorithmRunning)       status = "Paused";
         else if (gameState.isGameOver()) status = gameState.isGameWon() ? "Reached the Exit!" : "Game Over";
         else                             status = "Playing";
 
-        std::string gold = std::to_string(gameState.getGold());
-
-        gui::DrawableString::draw("Current Gold", 12, gui::Rect(x + 20, cy, x + 20 + hw - 15, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Center);
-        gui::DrawableString::draw(gold.c_str(), gold.length(), gui::Rect(x + 20, cy + 25, x + 20 + hw - 15, cy + 50), gui::Font::ID::SystemBold, td::ColorID::Yellow, td::TextAlignment::Left, td::VAlignment::Center);
-        gui::DrawableString::draw("Status", 6, gui::Rect(x + 20 + hw + 15, cy, x + width - 20, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Right, td::VAlignment::Center);
-        gui::DrawableString::draw(status.c_str(), status.length(), gui::Rect(x + 20 + hw + 15, cy + 25, x + width - 20, cy + 50), gui::Font::ID::SystemBold, td::ColorID::LightGreen, td::TextAlignment::Right, td::VAlignment::Center);
+        int gold = gameState.getGold();
+        drawLabel(TEXT_GOLD_LABEL, "Current Gold", gui::Rect(x + 20, cy, x + 20 + hw - 15, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Center);
+        drawCachedText(TEXT_GOLD, textKey({ (double)gold }), [gold] { return std::to_string(gold); },
+            gui::Rect(x + 20, cy + 25, x + 20 + hw - 15, cy + 50), gui::Font::ID::SystemBold, td::ColorID::Yellow, td::TextAlignment::Left, td::VAlignment::Center);
+        drawLabel(TEXT_STATUS_LABEL, "Status", gui::Rect(x + 20 + hw + 15, cy, x + width - 20, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Right, td::VAlignment::Center);
+        drawLabel(TEXT_STATUS, status, gui::Rect(x + 20 + hw + 15, cy + 25, x + width - 20, cy + 50), gui::Font::ID::SystemBold, td::ColorID::LightGreen, td::TextAlignment::Right, td::VAlignment::Center);
         cy += 65;
 
-        std::string pathStr = algorithmRunning ? std::to_string(currentPathIndex) + "/" + std::to_string(fullAlgorithmPath.size()) : "0";
-        std::string explStr = algorithmRunning ? std::to_string(currentExploredIndex) + "/" + std::to_string(fullExploredNodes.size()) : "0";
-
-        gui::DrawableString::draw("Path Progress", 13, gui::Rect(x + 20, cy, x + 20 + hw - 15, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Center);
-        gui::DrawableString::draw(pathStr.c_str(), pathStr.length(), gui::Rect(x + 20, cy + 25, x + 20 + hw - 15, cy + 50), gui::Font::ID::SystemBold, td::ColorID::Yellow, td::TextAlignment::Left, td::VAlignment::Center);
-        gui::DrawableString::draw("Explored Nodes", 14, gui::Rect(x + 20 + hw + 15, cy, x + width - 20, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Right, td::VAlignment::Center);
-        gui::DrawableString::draw(explStr.c_str(), explStr.length(), gui::Rect(x + 20 + hw + 15, cy + 25, x + width - 20, cy + 50), gui::Font::ID::SystemBold, td::ColorID::LightGreen, td::TextAlignment::Right, td::VAlignment::Center);
+        size_t pathShown = algorithmRunning ? currentPathIndex : 0, pathTotal = algorithmRunning ? activeRun->result.path.size() : 0;
+        size_t explShown = algorithmRunning ? currentExploredIndex : 0, explTotal = algorithmRunning ? activeRun->result.exploredNodes.size() : 0;
+        bool running = algorithmRunning;
+        auto fraction = [running](size_t shown, size_t total) {
+            return running ? std::to_string(shown) + "/" + std::to_string(total) : std::string("0");
+        };
+
+        drawLabel(TEXT_PATH_LABEL, "Path Progress", gui::Rect(x + 20, cy, x + 20 + hw - 15, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Center);
+        drawCachedText(TEXT_PATH, textKey({ (double)running, (double)pathShown, (double)pathTotal }), [&] { return fraction(pathShown, pathTotal); },
+            gui::Rect(x + 20, cy + 25, x + 20 + hw - 15, cy + 50), gui::Font::ID::SystemBold, td::ColorID::Yellow, td::TextAlignment::Left, td::VAlignment::Center);
+        drawLabel(TEXT_EXPLORED_LABEL, "Explored Nodes", gui::Rect(x + 20 + hw + 15, cy, x + width - 20, cy + 22), gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Right, td::VAlignment::Center);
+        gui::Rect explRect(x + 20 + hw + 15, cy + 25, x + width - 20, cy + 50);
+        if (solveJob && solveJob->type == AlgorithmType::MDP) {
+            unsigned sweeps = solveJob->progress.sweeps.load();
+            double residual = solveJob->progress.residual.load();
+            drawCachedText(TEXT_EXPLORED, textKey({ -1.0, (double)sweeps, residual }), [sweeps, residual] {
+                char buf[64];
+                snprintf(buf, sizeof(buf), "sweep %u, res %.3g", sweeps, residual);
+                return std::string(buf);
+                }, explRect, gui::Font::ID::SystemBold, td::ColorID::LightGreen, td::TextAlignment::Right, td::VAlignment::Center);
+        }
+        else if (solveJob) {
+            unsigned expanded = solveJob->progress.expanded.load();
+            drawCachedText(TEXT_EXPLORED, textKey({ -2.0, (double)expanded }), [expanded] { return std::to_string(expanded); },
+                explRect, gui::Font::ID::SystemBold, td::ColorID::LightGreen, td::TextAlignment::Right, td::VAlignment::Center);
+        }
+        else {
+            drawCachedText(TEXT_EXPLORED, textKey({ (double)running, (double)explShown, (double)explTotal }), [&] { return fraction(explShown, explTotal); },
+                explRect, gui::Font::ID::SystemBold, td::ColorID::LightGreen, td::TextAlignment::Right, td::VAlignment::Center);
+        }
     }
 
     void drawControlButtons(gui::CoordType x, gui::CoordType y, gui::CoordType width) {
@@ -454,47 +1193,139 @@ private:
 
         startButtonRect = gui::Rect(x, y, x + hw, y + bh);
         pauseButtonRect = gui::Rect(x + hw + 12, y, x + width, y + bh);
-        drawButton("START", x, y, hw, bh, td::ColorID::Moss, algorithmRunning && !isAnimating);
-        drawButton("PAUSE", x + hw + 12, y, hw, bh, td::ColorID::Moss, algorithmRunning && isAnimating);
+        drawButton(SHAPE_BUTTON_START, "START", x, y, hw, bh, td::ColorID::Moss, algorithmRunning && !isAnimating);
+        drawButton(SHAPE_BUTTON_PAUSE, "PAUSE", x + hw + 12, y, hw, bh, td::ColorID::Moss, algorithmRunning && isAnimating);
         y += bh + gap;
 
         stepButtonRect = gui::Rect(x, y, x + hw, y + bh);
         resetButtonRect = gui::Rect(x + hw + 12, y, x + width, y + bh);
-        drawButton("STEP", x, y, hw, bh, td::ColorID::Moss, algorithmRunning && !isAnimating);
-        drawButton("RESET", x + hw + 12, y, hw, bh, td::ColorID::Moss, algorithmRunning);
+        drawButton(SHAPE_BUTTON_STEP, "STEP", x, y, hw, bh, td::ColorID::Moss, algorithmRunning && !isAnimating);
+        drawButton(SHAPE_BUTTON_RESET, "RESET", x + hw + 12, y, hw, bh, td::ColorID::Moss, algorithmRunning);
         y += bh + gap;
 
-        generateNewGameRect = gui::Rect(x, y, x + width, y + bh);
-        drawButton("GENERATE NEW DUNGEON", x, y, width, bh, td::ColorID::Copper, true);
+        gui::CoordType gw = width * 0.62;
+        generateNewGameRect = gui::Rect(x, y, x + gw, y + bh);
+        tournamentButtonRect = gui::Rect(x + gw + 12, y, x + width, y + bh);
+        drawButton(SHAPE_BUTTON_GENERATE, "GENERATE NEW DUNGEON", x, y, gw, bh, td::ColorID::Copper, true);
+        drawButton(SHAPE_BUTTON_TOURNAMENT, "TOURNAMENT", x + gw + 12, y, width - gw - 12, bh, td::ColorID::Copper, !showTournament);
     }
 
-    void drawButton(const char* label, gui::CoordType x, gui::CoordType y, gui::CoordType w, gui::CoordType h, td::ColorID color, bool enabled) {
+    void drawButton(PanelShape slot, const char* label, gui::CoordType x, gui::CoordType y, gui::CoordType w, gui::CoordType h, td::ColorID color, bool enabled) {
         gui::Rect r(x, y, x + w, y + h);
-        gui::Shape bg; bg.createRoundedRect(r, 6); bg.drawFill(enabled ? color : td::ColorID::DimGray);
-        gui::Shape border; border.createRoundedRect(r, 6); border.drawWire(enabled ? td::ColorID::Gray : td::ColorID::DarkGray, 1);
-        gui::DrawableString::draw(label, strlen(label), r, gui::Font::ID::SystemNormal, td::ColorID::White, td::TextAlignment::Center, td::VAlignment::Center);
+        const gui::Shape& bg = panelShape(slot, r, 6);
+        bg.drawFill(enabled ? color : td::ColorID::DimGray);
+        bg.drawWire(enabled ? td::ColorID::Gray : td::ColorID::DarkGray, 1);
+        drawLabel(TEXT_BUTTONS + (slot - SHAPE_BUTTON_START), label, r, gui::Font::ID::SystemNormal, td::ColorID::White, td::TextAlignment::Center, td::VAlignment::Center);
     }
 
     void drawComparisonTable(gui::CoordType x, gui::CoordType y, gui::CoordType width) {
-        gui::DrawableString::draw("Algorithm Comparison", 21,
+        drawLabel(TEXT_TABLE_TITLE, "Algorithm Comparison",
             gui::Rect(x, y, x + width, y + 30),
             gui::Font::ID::SystemNormal, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Center);
         y += 35;
 
-        gui::CoordType tableH = currentAlgorithm > 0 ? 200 : 80;
-        gui::Shape bg; bg.createRoundedRect(gui::Rect(x, y, x + width, y + tableH), 6); bg.drawFill(td::ColorID::Moss);
-        gui::Shape border; border.createRoundedRect(gui::Rect(x, y, x + width, y + tableH), 6); border.drawWire(td::ColorID::LightGreen, 2);
-
-        if (currentAlgorithm > 0)
+        gui::CoordType tableH = currentAlgorithm == 6 ? 250 : (currentAlgorithm > 0 ? 225 : 80);
+        if (showTournament && tournamentReady) tableH = 200;
+        const gui::Shape& bg = panelShape(SHAPE_TABLE, gui::Rect(x, y, x + width, y + tableH), 6);
+        bg.drawFill(td::ColorID::Moss); bg.drawWire(td::ColorID::LightGreen, 2);
+
+        if (showTournament && tournamentReady)
+            drawTournamentTable(x + 15, y + 15, width - 30);
+        else if (showTournament && tournamentJob) {
+            unsigned done = tournamentJob->progress.expanded.load();
+            std::uint64_t total = tournamentJob->options.dungeons;
+            drawCachedText(TEXT_TABLE_HINT, textKey({ -1.0, (double)done }), [done, total] {
+                char buf[96];
+                snprintf(buf, sizeof(buf), "Running tournament… %u / %llu dungeons", done, (unsigned long long)total);
+                return std::string(buf);
+                }, gui::Rect(x + 20, y + 30, x + width - 20, y + 60),
+                gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Center, td::VAlignment::Center);
+        }
+        else if (currentAlgorithm > 0)
             drawAlgorithmDetails(x + 15, y + 15, width - 10);
         else {
             const char* msg = "Select and run an algorithm to see details";
-            gui::DrawableString::draw(msg, strlen(msg),
+            drawLabel(TEXT_TABLE_HINT, msg,
                 gui::Rect(x + 20, y + 30, x + width - 20, y + 60),
                 gui::Font::ID::SystemNormal, td::ColorID::LightGray, td::TextAlignment::Center, td::VAlignment::Center);
         }
     }
 
+    void runTournament() {
+        if (tournamentJob) return;
+        tournamentJob = std::make_unique<TournamentJob>();
+        TournamentJob* job = tournamentJob.get();
+        job->options.dungeons = TOURNAMENT_DUNGEONS;
+        job->options.seed = gameSeed;
+        job->options.progress = &job->progress;
+        job->thread = std::thread([job]() {
+            job->result = DungeonTournament::run(job->options);
+            job->done.store(true, std::memory_order_release);
+            });
+
+        // Keeps onDraw coming so the progress stays live.
+        gui::Canvas::startAnimation();
+    }
+
+    // Runs from onDraw: takes over a finished tournament.
+    void pollTournamentJob() {
+        if (!tournamentJob || !tournamentJob->done.load(std::memory_order_acquire)) return;
+        tournamentJob->thread.join();
+        tournament = std::move(tournamentJob->result);
+        tournamentReady = true;
+        tournamentJob.reset();
+        stopAnimationIfIdle();
+    }
+
+    void cancelTournamentJob() {
+        if (!tournamentJob) return;
+        tournamentJob->progress.cancel();
+        if (tournamentJob->thread.joinable()) tournamentJob->thread.join();
+        tournamentJob.reset();
+        stopAnimationIfIdle();
+    }
+
+    // Stops the frame timer unless a worker or a playback still needs frames.
+    void stopAnimationIfIdle() {
+        if (solveJob || tournamentJob || (inspectMap && !inspectMapReady()) || (race && race->finished < 6) || (algorithmRunning && isAnimating)) return;
+        gui::Canvas::stopAnimation();
+    }
+
+    void drawTournamentTable(gui::CoordType x, gui::CoordType y, gui::CoordType width) {
+        const char* headers[] = { "Algorithm", "Win %", "Cost", "Gold", "Expanded", "p50 us", "p99 us" };
+        const double cols[] = { 0.0, 0.24, 0.37, 0.50, 0.63, 0.76, 0.88 };
+        gui::CoordType lh = 20, cy = y;
+        int slot = TEXT_TOURNAMENT;
+
+        drawCachedText(slot++, textKey({ (double)tournament.options.dungeons, tournament.seconds }), [this] {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "%llu dungeons, %.2f s", (unsigned long long)tournament.options.dungeons, tournament.seconds);
+            return std::string(buf);
+            }, gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemBold, td::ColorID::Yellow, td::TextAlignment::Left, td::VAlignment::Top);
+        cy += lh + 6;
+
+        for (int c = 0; c < 7; c++) {
+            gui::CoordType cx = x + width * cols[c];
+            drawLabel(slot++, headers[c], gui::Rect(cx, cy, cx + width * 0.13, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Top);
+        }
+        cy += lh + 2;
+
+        for (const DungeonTournament::AlgorithmStats& a : tournament.algorithms) {
+            double values[] = { a.winRate() * 100.0, a.meanPathCost(), a.meanGoldAtExit(), a.meanExpansions(), a.timeP50, a.timeP99 };
+            drawLabel(slot++, DungeonHeadless::plannerName(a.planner), gui::Rect(x, cy, x + width * 0.24, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Top);
+            for (int c = 1; c < 7; c++) {
+                gui::CoordType cx = x + width * cols[c];
+                double v = values[c - 1];
+                drawCachedText(slot++, textKey({ v }), [v] {
+                    char buf[32];
+                    snprintf(buf, sizeof(buf), "%.1f", v);
+                    return std::string(buf);
+                    }, gui::Rect(cx, cy, cx + width * 0.13, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::LightGreen, td::TextAlignment::Left, td::VAlignment::Top);
+            }
+            cy += lh;
+        }
+    }
+
     void drawAlgorithmDetails(gui::CoordType x, gui::CoordType y, gui::CoordType width) {
         const char* name = "", * desc = "", * heuristic = "", * timeC = "", * spaceC = "";
 
@@ -530,23 +1361,82 @@ private:
         }
 
         gui::CoordType lh = 20, cy = y;
-        gui::DrawableString::draw(name, strlen(name), gui::Rect(x, cy, x + width, cy + lh + 2), gui::Font::ID::SystemBold, td::ColorID::Yellow, td::TextAlignment::Left, td::VAlignment::Top);
+        drawLabel(TEXT_DETAILS, name, gui::Rect(x, cy, x + width, cy + lh + 2), gui::Font::ID::SystemBold, td::ColorID::Yellow, td::TextAlignment::Left, td::VAlignment::Top);
         cy += lh + 8;
-        gui::DrawableString::draw(desc, strlen(desc), gui::Rect(x, cy, x + width, cy + lh * 3), gui::Font::ID::SystemSmaller, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Top);
+        drawLabel(TEXT_DETAILS + 1, desc, gui::Rect(x, cy, x + width, cy + lh * 3), gui::Font::ID::SystemSmaller, td::ColorID::LightGray, td::TextAlignment::Left, td::VAlignment::Top);
         cy += lh * 2 + 12;
 
-        char buf[128];
-        snprintf(buf, sizeof(buf), "Heuristic: %s", heuristic);
-        gui::DrawableString::draw(buf, strlen(buf), gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Top);
+        auto prefixed = [](const char* prefix, const char* text) { return std::string(prefix) + text; };
+        drawCachedText(TEXT_DETAILS + 2, (std::uint64_t)(std::uintptr_t)heuristic, [&] { return prefixed("Heuristic: ", heuristic); },
+            gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::White, td::TextAlignment::Left, td::VAlignment::Top);
+        cy += lh + 6;
+        drawCachedText(TEXT_DETAILS + 3, (std::uint64_t)(std::uintptr_t)timeC, [&] { return prefixed("Time Complexity: ", timeC); },
+            gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::LightGreen, td::TextAlignment::Left, td::VAlignment::Top);
         cy += lh + 6;
-        snprintf(buf, sizeof(buf), "Time Complexity: %s", timeC);
-        gui::DrawableString::draw(buf, strlen(buf), gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::LightGreen, td::TextAlignment::Left, td::VAlignment::Top);
+        drawCachedText(TEXT_DETAILS + 4, (std::uint64_t)(std::uintptr_t)spaceC, [&] { return prefixed("Space Complexity: ", spaceC); },
+            gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::LightGreen, td::TextAlignment::Left, td::VAlignment::Top);
         cy += lh + 6;
-        snprintf(buf, sizeof(buf), "Space Complexity: %s", spaceC);
-        gui::DrawableString::draw(buf, strlen(buf), gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::LightGreen, td::TextAlignment::Left, td::VAlignment::Top);
+        long long execUs = activeRun->execTimeUs;
+        drawCachedText(TEXT_DETAILS + 5, textKey({ (double)execUs }), [execUs] {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "Execution Time: %.3f ms", execUs / 1000.0);
+            return std::string(buf);
+            }, gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::Cyan, td::TextAlignment::Left, td::VAlignment::Top);
         cy += lh + 6;
-        snprintf(buf, sizeof(buf), "Execution Time: %.3f ms", algorithmExecTimeUs / 1000.0);
-        gui::DrawableString::draw(buf, strlen(buf), gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::Cyan, td::TextAlignment::Left, td::VAlignment::Top);
+        const DungeonRollout::RolloutStats& rollout = activeRun->rollout;
+        drawCachedText(TEXT_DETAILS + 6, textKey({ rollout.winRate, (double)rollout.goldP50, (double)rollout.goldP90, (double)rollout.episodes }), [&] {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "Monte Carlo: %.1f%% wins, gold p50 %d / p90 %d (%llu runs)",
+                rollout.winRate * 100.0, rollout.goldP50, rollout.goldP90, (unsigned long long)rollout.episodes);
+            return std::string(buf);
+            }, gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::Cyan, td::TextAlignment::Left, td::VAlignment::Top);
+
+        if (currentAlgorithm == 6) {
+            const DungeonMDP::MDPResult& mdpDetails = activeRun->mdp;
+            const DungeonMDP::MDPTelemetry& t = mdpDetails.telemetry;
+            double residual = t.residuals.empty() ? 0.0 : t.residuals.back();
+            cy += lh + 6;
+            drawCachedText(TEXT_DETAILS + 7, textKey({ (double)t.iterations, (double)t.epsilonOptimal, (double)t.converged,
+                (double)mdpDetails.cacheHit, residual, t.backupsPerSecond, t.secondsPerSweep }), [&] {
+                const char* stop = t.epsilonOptimal ? "eps-optimal" : (t.converged ? "converged" : "iteration cap");
+                char buf[128];
+                snprintf(buf, sizeof(buf), "Sweeps: %d (%s%s), residual %.2g, %.1fM backups/s, %.3f ms/sweep",
+                    t.iterations, stop, mdpDetails.cacheHit ? ", cached" : "",
+                    residual, t.backupsPerSecond / 1e6, t.secondsPerSweep * 1000.0);
+                return std::string(buf);
+                }, gui::Rect(x, cy, x + width, cy + lh), gui::Font::ID::SystemSmaller, td::ColorID::Cyan, td::TextAlignment::Left, td::VAlignment::Top);
+        }
+    }
+
+    // Journals the attempt first, so events raised inside movePlayer are recorded after it.
+    void tryMove(int dx, int dy) {
+        int x = gameState.getPlayerX() + dx, y = gameState.getPlayerY() + dy;
+        journal.move(x, y);
+        bool moved = gameState.movePlayer(x, y);
+        handleGameEvents();
+        if (moved) { playSoundtrack(); reDrawMove(); }
+    }
+
+    // Repaints what a move can change: the bounding box of the board cells GameState
+    // marked dirty (onDraw has not synced them yet) and the control panel. Anything
+    // that covers the board with other content falls back to a full repaint.
+    void reDrawMove() {
+        int n = gameState.getDirtyCount();
+        if (n == 0 || !gridLayer.valid || race || inspecting || algorithmRunning || profiler.isEnabled()) {
+            reDraw();
+            return;
+        }
+        const std::uint8_t* cells = gameState.getDirtyCells();
+        int x0 = GameState::GRID_SIZE, y0 = GameState::GRID_SIZE, x1 = -1, y1 = -1;
+        for (int i = 0; i < n; i++) {
+            int x = GameState::cellX(cells[i]), y = GameState::cellY(cells[i]);
+            x0 = std::min(x0, x); x1 = std::max(x1, x);
+            y0 = std::min(y0, y); y1 = std::max(y1, y);
+        }
+        const GridLayer& g = gridLayer;
+        reDraw(gui::Rect(g.startX + x0 * g.cellSize, g.startY + y0 * g.cellSize,
+            g.startX + (x1 + 1) * g.cellSize, g.startY + (y1 + 1) * g.cellSize));
+        reDraw(gui::Rect(rightZoneLeft, 0, canvasSize.width, canvasSize.height));
     }
 
     void playSoundtrack() {
@@ -558,22 +1448,24 @@ private:
 
 protected:
     bool onKeyPressed(const gui::Key& key) override {
+        if (inspecting && handleInspectKey(key)) return true;
+
         if (key.isVirtual()) {
             gui::Key::Virtual k = key.getVirtual();
             if (k == gui::Key::Virtual::Right) {
-                if (gameState.movePlayer(gameState.getPlayerX() + 1, gameState.getPlayerY())) { playSoundtrack(); reDraw(); }
+                tryMove(1, 0);
                 return true;
             }
             if (k == gui::Key::Virtual::Left) {
-                if (gameState.movePlayer(gameState.getPlayerX() - 1, gameState.getPlayerY())) { playSoundtrack(); reDraw(); }
+                tryMove(-1, 0);
                 return true;
             }
             if (k == gui::Key::Virtual::Up) {
-                if (gameState.movePlayer(gameState.getPlayerX(), gameState.getPlayerY() - 1)) { playSoundtrack(); reDraw(); }
+                tryMove(0, -1);
                 return true;
             }
             if (k == gui::Key::Virtual::Down) {
-                if (gameState.movePlayer(gameState.getPlayerX(), gameState.getPlayerY() + 1)) { playSoundtrack(); reDraw(); }
+                tryMove(0, 1);
                 return true;
             }
         }
@@ -581,19 +1473,37 @@ protected:
         if (key.isASCII()) {
             char ch = key.getChar();
             if (ch == 'w' || ch == 'W') {
-                if (gameState.movePlayer(gameState.getPlayerX(), gameState.getPlayerY() - 1)) { playSoundtrack(); reDraw(); }
+                tryMove(0, -1);
                 return true;
             }
             if (ch == 's' || ch == 'S') {
-                if (gameState.movePlayer(gameState.getPlayerX(), gameState.getPlayerY() + 1)) { playSoundtrack(); reDraw(); }
+                tryMove(0, 1);
                 return true;
             }
             if (ch == 'a' || ch == 'A') {
-                if (gameState.movePlayer(gameState.getPlayerX() - 1, gameState.getPlayerY())) { playSoundtrack(); reDraw(); }
+                tryMove(-1, 0);
                 return true;
             }
             if (ch == 'd' || ch == 'D') {
-                if (gameState.movePlayer(gameState.getPlayerX() + 1, gameState.getPlayerY())) { playSoundtrack(); reDraw(); }
+                tryMove(1, 0);
+                return true;
+            }
+            if (ch == 'l' || ch == 'L') {
+                toggleInspection();
+                return true;
+            }
+            if (ch == 'r' || ch == 'R') {
+                toggleRace();
+                return true;
+            }
+            if (ch == 'p' || ch == 'P') {
+                profiler.setEnabled(!profiler.isEnabled());
+                reDraw();
+                return true;
+            }
+            if (ch == 'o' || ch == 'O') {
+                toggleProfilerDump();
+                reDraw();
                 return true;
             }
         }
@@ -604,8 +1514,16 @@ protected:
     void onPrimaryButtonPressed(const gui::InputDevice& inputDevice) override {
         gui::Point click = inputDevice.getModelPoint();
 
+        if (inspecting && gridLayer.bounds.contains(click)) {
+            dragging = true;
+            dragLast = click;
+            return;
+        }
+
         if (speedButtonRect.contains(click)) { speedControlExpanded = !speedControlExpanded; reDraw(); return; }
         if (speedControlExpanded && speedSliderRect.contains(click)) { handleSpeedSliderClick(click); return; }
+        // The race owns the animation timer; only the shared speed is adjustable until R closes it.
+        if (race) return;
         if (dropdownRect.contains(click)) { dropdownExpanded = !dropdownExpanded; reDraw(); return; }
 
         if (dropdownExpanded) {
@@ -613,6 +1531,7 @@ protected:
                 if (dropdownItemRects[i].contains(click)) {
                     currentAlgorithm = i + 1;
                     dropdownExpanded = false;
+                    showTournament = false;
                     if (gameState.isGameOver())
                         runAlgorithm(static_cast<AlgorithmType>(currentAlgorithm));
                     reDraw();
@@ -629,9 +1548,36 @@ protected:
         if (stepButtonRect.contains(click) && algorithmRunning) { stepAnimation();  return; }
         if (resetButtonRect.contains(click) && algorithmRunning) { resetAlgorithmVisualization(); return; }
         if (generateNewGameRect.contains(click)) { resetGame(); return; }
+        if (tournamentButtonRect.contains(click)) {
+            showTournament = !showTournament;
+            if (showTournament && !tournamentReady) runTournament();
+            reDraw();
+            return;
+        }
+    }
+
+    void onPrimaryButtonReleased(const gui::InputDevice& inputDevice) override {
+        dragging = false;
+    }
+
+    void onCursorDragged(const gui::InputDevice& inputDevice) override {
+        if (!inspecting || !dragging) return;
+        gui::Point p = inputDevice.getModelPoint();
+        camera.pan(p.x - dragLast.x, p.y - dragLast.y);
+        dragLast = p;
+        reDraw();
+    }
+
+    bool onZoom(const gui::InputDevice& inputDevice) override {
+        if (!inspecting || inputDevice.getScale() <= 0) return false;
+        gui::Point p = inputDevice.getModelPoint();
+        camera.zoomAt(inputDevice.getScale(), p.x - gridLayer.bounds.left, p.y - gridLayer.bounds.top);
+        reDraw();
+        return true;
     }
 
     void onResize(const gui::Size& newSize) override {
+        canvasSize = newSize;
         gui::CoordType minDim = std::min(newSize.width, newSize.height);
         leftZoneWidth = minDim * 0.9;
         leftZoneLeft = newSize.width * 0.03;
@@ -640,28 +1586,46 @@ protected:
         rightZoneLeft = leftZoneLeft + leftZoneWidth + gap;
         rightZoneWidth = newSize.width - rightZoneLeft - (newSize.width * 0.03);
         rightZoneTop = newSize.height * 0.05;
+        invalidateLayout();
+        cameraFitted = false;
         reDraw();
     }
 
     void onDraw(const gui::Rect& rect) override {
-        processPendingMine();
-        processPendingMineResult();
+        const bool profiling = profiler.isEnabled();
+        if (profiling) profiler.beginFrame();
 
+        syncBoardCells();
+
+        pollSolveJob();
+        pollTournamentJob();
+        pollInspectMap();
+        if (race) updateRace();
         if (algorithmRunning && isAnimating) updateAnimation();
         if (algorithmRunning) updateVisualization();
 
-        gui::Shape bg;
-        bg.createRect(rect);
-        bg.drawFill(td::ColorID::Moss);
+        if (profiling) profiler.enter(FrameProfiler::PHASE_GRID);
+        panelShape(SHAPE_FRAME, rect, 0).drawFill(td::ColorID::Moss);
+        if (race) drawRaceView(rect);
+        else if (inspecting) drawInspectView();
+        else drawGameGrid(rect);
 
-        drawGameGrid();
+        if (profiling) profiler.enter(FrameProfiler::PHASE_PANEL);
         drawControlPanel();
+
+        if (profiling) {
+            profiler.enter(FrameProfiler::PHASE_HUD);
+            drawProfilerHud();
+            profiler.endFrame();
+        }
     }
 
 public:
     SimulationCanvas()
-        : gui::Canvas({ gui::InputDevice::Event::Keyboard, gui::InputDevice::Event::PrimaryClicks })
-        , rng(std::random_device{}())
+        : gui::Canvas({ gui::InputDevice::Event::Keyboard, gui::InputDevice::Event::PrimaryClicks,
+            gui::InputDevice::Event::CursorDrag, gui::InputDevice::Event::Zoom })
+        , gameSeed(std::random_device{}())
+        , rng(gameSeed)
         , gameState(rng)
         , imgPlayer(":player")
         , imgReward(":reward")
@@ -677,14 +1641,31 @@ public:
         , sndSoundtrack(":soundtrack") {
 
         enableResizeEvent(true);
+        sprites[GameState::PLAYER] = &imgPlayer;
+        sprites[GameState::REWARD] = &imgReward;
+        sprites[GameState::BANDIT] = &imgBandit;
+        sprites[GameState::MINE] = &imgMine;
+        sprites[GameState::EXIT] = &imgExit;
         lastAnimationTime = std::chrono::steady_clock::now();
 
-        gameState.setGameEventCallback([this](const std::string& event, int value) {
-            handleGameEvent(event, value);
-            });
+        gameState.setEventQueue(&gameEvents);
+
+        startPrecompute();
+
+        if (const char* journalPath = std::getenv("DUNGEON_JOURNAL")) {
+            if (journal.open(journalPath))
+                journal.newGame(gameSeed, gameState.getInitialState().layoutHash);
+        }
     }
 
-    ~SimulationCanvas() = default;
+    ~SimulationCanvas() {
+        // The generator cannot be cancelled; this waits out at most one build.
+        if (inspectMap && inspectMap->thread.joinable()) inspectMap->thread.join();
+        cancelTournamentJob();
+        stopRace();
+        cancelSolveJob();
+        stopPrecompute();
+    }
 
     bool isGameOver() const { return gameState.isGameOver(); }
     bool isGameWon()  const { return gameState.isGameWon(); }
@@ -694,41 +1675,178 @@ public:
         return { gameState.getPlayerX(), gameState.getPlayerY() };
     }
 
-    void setAnimationSpeed(int speedMS) { animationSpeed = speedMS; }
+    void setAnimationSpeed(int speedMS) { animationSpeed = std::max(1, speedMS); }
     int  getAnimationSpeed() const { return animationSpeed; }
 
+    // Shows a cached result straight away; otherwise solves it on a worker.
     void runAlgorithm(AlgorithmType type) {
         if (!gameState.isGameOver()) return;
 
-        algorithmRunning = true;
-        isAnimating = (type != AlgorithmType::BFS);
+        cancelSolveJob();
+        currentAlgorithm = static_cast<int>(type);
 
-        const auto& initialState = gameState.getInitialState();
-        std::pair<int, int> start = { initialState.playerStartX, initialState.playerStartY };
-        std::pair<int, int> exit = { initialState.exitX,        initialState.exitY };
+        std::shared_ptr<const AlgorithmRun> run = cachedRun(type, gameState.getGold());
+        if (run) {
+            showRun(run);
+            return;
+        }
 
-        auto searchStart = std::chrono::steady_clock::now();
+        algorithmRunning = false;
+        isAnimating = false;
+        activeRun = std::make_shared<AlgorithmRun>();
+
+        solveJob = std::make_unique<SolveJob>();
+        SolveJob* job = solveJob.get();
+        job->type = type;
+        job->gold = gameState.getGold();
+        GameState::InitialState layout = gameState.getInitialState();
+        job->thread = std::thread([job, layout]() {
+            job->run = computeRun(job->type, layout, job->gold, &job->progress);
+            job->done.store(true, std::memory_order_release);
+            });
 
-        DungeonAlgorithms::SearchResult result;
-        if (type == AlgorithmType::BFS)    result = DungeonAlgorithms::bfsSearch(initialState.actualGrid, start, exit);
-        else if (type == AlgorithmType::DFS)    result = DungeonAlgorithms::dfsSearch(initialState.actualGrid, start, exit);
-        else if (type == AlgorithmType::DIJKSTRA)    result = DungeonAlgorithms::dijkstraSearch(initialState.actualGrid, start, exit);
-        else if (type == AlgorithmType::AStar)  result = DungeonAlgorithms::aStarSearch(initialState.actualGrid, start, exit);
-        else if (type == AlgorithmType::Greedy) result = DungeonAlgorithms::greedySearch(initialState.actualGrid, start, exit);
-        else if (type == AlgorithmType::MDP)    result = DungeonAlgorithms::mdpSearch(initialState.actualGrid, start, exit, gameState.getGold());
+        // Keeps onDraw coming so the progress stays live.
+        gui::Canvas::startAnimation();
+        reDraw();
+    }
 
-        auto searchEnd = std::chrono::steady_clock::now();
-        algorithmExecTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(searchEnd - searchStart).count();
+    void showRun(const std::shared_ptr<const AlgorithmRun>& run) {
+        algorithmRunning = true;
+        isAnimating = (run->type != AlgorithmType::BFS);
+        activeRun = run;
 
-        fullAlgorithmPath = result.path;
-        fullExploredNodes = result.exploredNodes;
-        currentAlgorithm = static_cast<int>(type);
         lastAnimationTime = std::chrono::steady_clock::now();
         currentExploredIndex = 0;
         currentPathIndex = 0;
         animationPhase = 0;
 
         setupAlgorithmVisualization();
+        if (isAnimating) gui::Canvas::startAnimation();
+    }
+
+    // Runs from onDraw: takes over a finished solve and caches it.
+    void pollSolveJob() {
+        if (!solveJob || !solveJob->done.load(std::memory_order_acquire)) return;
+        solveJob->thread.join();
+        std::shared_ptr<const AlgorithmRun> run = std::move(solveJob->run);
+        solveJob.reset();
+        stopAnimationIfIdle();
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            runCache[static_cast<int>(run->type) - 1] = run;
+        }
+        showRun(run);
+    }
+
+    void cancelSolveJob() {
+        if (!solveJob) return;
+        solveJob->progress.cancel();
+        if (solveJob->thread.joinable()) solveJob->thread.join();
+        solveJob.reset();
+        stopAnimationIfIdle();
+    }
+
+    // Returns nullptr if progress was cancelled before the search finished.
+    static std::shared_ptr<const AlgorithmRun> computeRun(AlgorithmType type, const GameState::InitialState& initialState, int gold,
+        SearchProgress* progress = nullptr) {
+        auto run = std::make_shared<AlgorithmRun>();
+        run->type = type;
+        run->startGold = gold;
+        std::pair<int, int> start = { initialState.playerStartX, initialState.playerStartY };
+        std::pair<int, int> exit = { initialState.exitX,        initialState.exitY };
+
+        auto searchStart = std::chrono::steady_clock::now();
+
+        DungeonAlgorithms::SearchResult& result = run->result;
+        if (type == AlgorithmType::BFS)    result = DungeonAlgorithms::bfsSearch(initialState.actualGrid, start, exit, progress);
+        else if (type == AlgorithmType::DFS)    result = DungeonAlgorithms::dfsSearch(initialState.actualGrid, start, exit, progress);
+        else if (type == AlgorithmType::DIJKSTRA)    result = DungeonAlgorithms::dijkstraSearch(initialState.actualGrid, start, exit, progress);
+        else if (type == AlgorithmType::AStar)  result = DungeonAlgorithms::aStarSearch(initialState.actualGrid, start, exit, progress);
+        else if (type == AlgorithmType::Greedy) result = DungeonAlgorithms::greedySearch(initialState.actualGrid, start, exit, progress);
+        else if (type == AlgorithmType::MDP)    result = DungeonAlgorithms::mdpSearch(initialState.actualGrid, start, exit, gold, &run->mdp, progress);
+        if (progress && progress->isCancelled()) return nullptr;
+
+        auto searchEnd = std::chrono::steady_clock::now();
+        run->execTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(searchEnd - searchStart).count();
+
+        DungeonRollout::RolloutOptions rolloutOptions;
+        rolloutOptions.episodes = ROLLOUT_EPISODES;
+        run->rollout = DungeonRollout::evaluatePath(GridView(initialState.actualGrid), result.path, rolloutOptions);
+        return run;
+    }
+
+    // Only MDP depends on the gold the player starts with.
+    std::shared_ptr<const AlgorithmRun> cachedRun(AlgorithmType type, int gold) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        const auto& run = runCache[static_cast<int>(type) - 1];
+        if (run && (type != AlgorithmType::MDP || run->startGold == gold)) return run;
+        return nullptr;
+    }
+
+    void stopPrecompute() {
+        cacheGeneration++;
+        if (precomputeProgress) precomputeProgress->cancel();
+        if (precomputeThread.joinable()) precomputeThread.join();
+    }
+
+    // Fills the cache for the current dungeon on a worker thread with the five searches,
+    // skipping entries that are already valid. MDP waits for precomputeMdp.
+    void startPrecompute() {
+        if (precomputeThread.joinable()) precomputeThread.join();   // stopped by stopPrecompute
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            pendingMdpGold = -1;
+            precomputeIdle = false;
+        }
+        launchPrecompute(true);
+    }
+
+    // Queues MDP for the gold the game ended with. A busy worker takes it after its
+    // searches, so the caller never waits; an idle one is replaced.
+    void precomputeMdp(int gold) {
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            pendingMdpGold = gold;
+            if (!precomputeIdle) return;
+            precomputeIdle = false;
+        }
+        if (precomputeThread.joinable()) precomputeThread.join();   // already returning
+        launchPrecompute(false);
+    }
+
+    void launchPrecompute(bool searches) {
+        std::uint64_t generation = cacheGeneration.load();
+        GameState::InitialState layout = gameState.getInitialState();
+        precomputeProgress = std::make_shared<SearchProgress>();
+        precomputeThread = std::thread([this, generation, layout, searches, progress = precomputeProgress]() {
+            for (int i = 1; searches && i < static_cast<int>(AlgorithmType::MDP); i++) {
+                AlgorithmType type = static_cast<AlgorithmType>(i);
+                if (cacheGeneration.load() != generation) {
+                    std::lock_guard<std::mutex> lock(cacheMutex);
+                    precomputeIdle = true;
+                    return;
+                }
+                if (cachedRun(type, 0)) continue;
+                std::shared_ptr<const AlgorithmRun> run = computeRun(type, layout, 0, progress.get());
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                if (!run || cacheGeneration.load() != generation) { precomputeIdle = true; return; }
+                runCache[i - 1] = run;
+            }
+            for (;;) {
+                int gold;
+                {
+                    std::lock_guard<std::mutex> lock(cacheMutex);
+                    gold = pendingMdpGold;
+                    pendingMdpGold = -1;
+                    if (gold < 0 || cacheGeneration.load() != generation) { precomputeIdle = true; return; }
+                }
+                if (cachedRun(AlgorithmType::MDP, gold)) continue;
+                std::shared_ptr<const AlgorithmRun> run = computeRun(AlgorithmType::MDP, layout, gold, progress.get());
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                if (!run || cacheGeneration.load() != generation) { precomputeIdle = true; return; }
+                runCache[static_cast<int>(AlgorithmType::MDP) - 1] = run;
+            }
+            });
     }
 
     void startAnimation() {
@@ -742,55 +1860,68 @@ public:
     void pauseAnimation() {
         if (!algorithmRunning) return;
         isAnimating = false;
-        gui::Canvas::stopAnimation();
+        stopAnimationIfIdle();
         reDraw();
     }
 
     void stepAnimation() {
         if (!algorithmRunning) return;
-        if (animationPhase == 0) {
-            if (currentExploredIndex < (int)fullExploredNodes.size()) currentExploredIndex++;
-            else animationPhase = 1;
-        }
-        else if (animationPhase == 1) {
-            if (currentPathIndex < (int)fullAlgorithmPath.size()) currentPathIndex++;
-        }
+        advanceAnimation(1);
         reDraw();
     }
 
+    // Applies up to `steps` animation steps: explored nodes first, then one step to
+    // switch to the path, then path cells. Returns false once the path is complete
+    // and a further step was asked for.
+    bool advanceAnimation(long long steps) {
+        const auto& r = activeRun->result;
+        while (steps > 0) {
+            if (animationPhase == 0) {
+                long long n = std::min<long long>(steps, (long long)r.exploredNodes.size() - currentExploredIndex);
+                currentExploredIndex += (int)n;
+                steps -= n;
+                if (steps > 0) { animationPhase = 1; steps--; }
+            }
+            else {
+                if (currentPathIndex >= (int)r.path.size()) return false;
+                long long n = std::min<long long>(steps, (long long)r.path.size() - currentPathIndex);
+                currentPathIndex += (int)n;
+                steps -= n;
+            }
+        }
+        return true;
+    }
+
+    // Applies every step that has fallen due since the last frame, one per
+    // animationSpeed ms, so playback speed does not depend on the frame rate. The
+    // fractional remainder carries over to the next frame.
     void updateAnimation() {
         if (!isAnimating || !algorithmRunning) return;
 
         auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastAnimationTime).count();
-        if (elapsed < animationSpeed) return;
-
-        if (animationPhase == 0) {
-            if (currentExploredIndex < (int)fullExploredNodes.size()) {
-                currentExploredIndex++;
-                lastAnimationTime = now;
-            }
-            else { animationPhase = 1; lastAnimationTime = now; }
-        }
-        else if (animationPhase == 1) {
-            if (currentPathIndex < (int)fullAlgorithmPath.size()) {
-                currentPathIndex++;
-                lastAnimationTime = now;
-            }
-            else { isAnimating = false; gui::Canvas::stopAnimation(); }
+        double elapsedMs = std::chrono::duration<double, std::milli>(now - lastAnimationTime).count();
+        long long due = (long long)(elapsedMs / animationSpeed);
+        if (due <= 0) return;
+        lastAnimationTime += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>((double)due * animationSpeed));
+
+        if (!advanceAnimation(due)) {
+            isAnimating = false;
+            stopAnimationIfIdle();
         }
     }
 
     void resetAlgorithmVisualization() {
+        cancelSolveJob();
         algorithmRunning = false;
         isAnimating = false;
+        stopAnimationIfIdle();
         currentAlgorithm = 0;
-        algorithmExecTimeUs = 0;
-        fullAlgorithmPath.clear();
-        fullExploredNodes.clear();
+        activeRun = std::make_shared<AlgorithmRun>();
         currentExploredIndex = 0;
         currentPathIndex = 0;
         animationPhase = 0;
+        journal.revealAll();
         gameState.resetVisualization();
         reDraw();
     }
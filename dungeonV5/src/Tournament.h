@@ -0,0 +1,239 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include "GameState.h"
+#include "Algorithms.h"
+#include "HeadlessEngine.h"
+#include "SearchProgress.h"
+
+// Runs every search algorithm on the same N seeded dungeons and aggregates the
+// results per algorithm. Dungeon i is generated from seed + i, and its mine questions
+// draw from the same stream for every algorithm, so the algorithms are compared on
+// identical games. Dungeons are split across threads. MDP solves bypass the shared
+// MDPCache, so every dungeon is solved cold and everything except the timings is
+// independent of the thread count.
+namespace DungeonTournament {
+
+    constexpr int NUM_ALGORITHMS = 6;
+
+    inline DungeonHeadless::Planner algorithmAt(int i) {
+        static const DungeonHeadless::Planner order[NUM_ALGORITHMS] = {
+            DungeonHeadless::Planner::BFS, DungeonHeadless::Planner::DFS, DungeonHeadless::Planner::Dijkstra,
+            DungeonHeadless::Planner::AStar, DungeonHeadless::Planner::Greedy, DungeonHeadless::Planner::MDP };
+        return order[i];
+    }
+
+    struct TournamentOptions {
+        std::uint64_t dungeons = 1000;
+        std::uint64_t seed = 1;
+        int threads = 0;                    // 0 = hardware concurrency
+        double mineSuccessProbability = DungeonMDP::MINE_SUCCESS_PROBABILITY;
+        // Optional. Polled for cancellation before each dungeon; `expanded` counts the
+        // dungeons finished so far. A cancelled run returns partial results.
+        SearchProgress* progress = nullptr;
+    };
+
+    struct AlgorithmStats {
+        DungeonHeadless::Planner planner = DungeonHeadless::Planner::BFS;
+        std::uint64_t games = 0;
+        std::uint64_t solved = 0;           // found a path to the exit
+        std::uint64_t wins = 0;             // reached the exit with enough gold
+        std::uint64_t poorExits = 0;
+        std::uint64_t pathCostSum = 0;      // getMoveCost along the path, solved games only
+        std::uint64_t pathLengthSum = 0;
+        std::uint64_t goldAtExitSum = 0;
+        std::uint64_t expansionsSum = 0;    // nodes off the frontier; for MDP, state backups (sweeps x states)
+        double timeP50 = 0.0, timeP90 = 0.0, timeP99 = 0.0, timeMean = 0.0;    // microseconds
+        std::vector<float> times;           // per-dungeon search time, microseconds
+
+        double winRate() const { return games ? (double)wins / games : 0.0; }
+        double meanPathCost() const { return solved ? (double)pathCostSum / solved : 0.0; }
+        double meanPathLength() const { return solved ? (double)pathLengthSum / solved : 0.0; }
+        double meanGoldAtExit() const { return solved ? (double)goldAtExitSum / solved : 0.0; }
+        double meanExpansions() const { return games ? (double)expansionsSum / games : 0.0; }
+
+        void merge(const AlgorithmStats& o) {
+            games += o.games; solved += o.solved; wins += o.wins; poorExits += o.poorExits;
+            pathCostSum += o.pathCostSum; pathLengthSum += o.pathLengthSum;
+            goldAtExitSum += o.goldAtExitSum; expansionsSum += o.expansionsSum;
+            times.insert(times.end(), o.times.begin(), o.times.end());
+        }
+
+        void finish() {
+            if (times.empty()) return;
+            double sum = 0.0;
+            for (float t : times) sum += t;
+            timeMean = sum / times.size();
+            auto at = [this](double q) {
+                size_t k = (size_t)(q * (double)(times.size() - 1));
+                std::nth_element(times.begin(), times.begin() + k, times.end());
+                return (double)times[k];
+            };
+            timeP50 = at(0.50);
+            timeP90 = at(0.90);
+            timeP99 = at(0.99);
+        }
+    };
+
+    struct TournamentResult {
+        TournamentOptions options;
+        AlgorithmStats algorithms[NUM_ALGORITHMS];
+        double seconds = 0.0;
+    };
+
+    // Searches one dungeon and reports the work done in `expansions`: nodes taken off the
+    // frontier, or for MDP the state backups of value iteration. The explored cells MDP
+    // returns are just the states with non-trivial value.
+    inline DungeonAlgorithms::SearchResult search(DungeonHeadless::Planner p, const GameState::InitialState& s,
+        std::uint64_t& expansions) {
+        std::pair<int, int> start = { s.playerStartX, s.playerStartY };
+        std::pair<int, int> exit = { s.exitX, s.exitY };
+        if (p == DungeonHeadless::Planner::MDP) {
+            DungeonMDP::MDPOptions options;
+            options.useCache = false;
+            DungeonMDP::MDPSolver solver(GridView(s.actualGrid), start, exit, 0, options);
+            DungeonMDP::MDPResult details = solver.solve();
+            expansions = details.telemetry.backups;
+            DungeonAlgorithms::SearchResult result;
+            result.path = details.path;
+            result.exploredNodes = details.exploredNodes;
+            return result;
+        }
+        expansions = 0;
+        DungeonAlgorithms::SearchResult result;
+        switch (p) {
+        case DungeonHeadless::Planner::BFS:      result = DungeonAlgorithms::bfsSearch(s.actualGrid, start, exit); break;
+        case DungeonHeadless::Planner::DFS:      result = DungeonAlgorithms::dfsSearch(s.actualGrid, start, exit); break;
+        case DungeonHeadless::Planner::Dijkstra: result = DungeonAlgorithms::dijkstraSearch(s.actualGrid, start, exit); break;
+        case DungeonHeadless::Planner::AStar:    result = DungeonAlgorithms::aStarSearch(s.actualGrid, start, exit); break;
+        case DungeonHeadless::Planner::Greedy:   result = DungeonAlgorithms::greedySearch(s.actualGrid, start, exit); break;
+        default:                                 return {};
+        }
+        expansions = result.exploredNodes.size();
+        return result;
+    }
+
+    // Plays one algorithm on one dungeon and adds the outcome to stats.
+    inline void playOne(const GameState::InitialState& layout, std::uint64_t dungeon, const TournamentOptions& options,
+        AlgorithmStats& stats) {
+        auto t0 = std::chrono::steady_clock::now();
+        std::uint64_t expansions = 0;
+        DungeonAlgorithms::SearchResult result = search(stats.planner, layout, expansions);
+        auto t1 = std::chrono::steady_clock::now();
+
+        stats.games++;
+        stats.expansionsSum += expansions;
+        stats.times.push_back((float)std::chrono::duration<double, std::micro>(t1 - t0).count());
+        if (result.path.empty()) return;
+
+        GameState game(layout);
+        DungeonRollout::CounterRng mineRng(options.seed, dungeon);
+        int cost = 0;
+        for (size_t i = 1; i < result.path.size() && !game.isGameOver(); i++) {
+            int x = result.path[i].first, y = result.path[i].second;
+            cost += DungeonAlgorithms::getMoveCost(layout.actualGrid[x][y]);
+            bool mine = game.getBoard().mine.test(x, y);
+            game.movePlayer(x, y);
+            if (mine && mineRng.uniform() >= options.mineSuccessProbability) game.applyMinePenalty();
+        }
+        if (!game.isGameOver()) return;
+
+        stats.solved++;
+        stats.pathCostSum += cost;
+        stats.pathLengthSum += result.path.size() - 1;
+        stats.goldAtExitSum += game.getGold();
+        if (game.hasMetRewardRequirement()) stats.wins++;
+        else stats.poorExits++;
+    }
+
+    inline TournamentResult run(const TournamentOptions& options) {
+        auto t0 = std::chrono::steady_clock::now();
+        int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+        threads = std::max(1, std::min<int>(threads, (int)std::max<std::uint64_t>(1, options.dungeons)));
+
+        std::vector<std::vector<AlgorithmStats>> partial(threads, std::vector<AlgorithmStats>(NUM_ALGORITHMS));
+        auto worker = [&](int t) {
+            std::vector<AlgorithmStats>& mine = partial[t];
+            for (int a = 0; a < NUM_ALGORITHMS; a++) mine[a].planner = algorithmAt(a);
+            std::uint64_t begin = options.dungeons * t / threads;
+            std::uint64_t end = options.dungeons * (t + 1) / threads;
+            for (auto& s : mine) s.times.reserve((size_t)(end - begin));
+
+            for (std::uint64_t d = begin; d < end; d++) {
+                if (options.progress && options.progress->isCancelled()) return;
+                std::mt19937 rng(static_cast<std::mt19937::result_type>(options.seed + d));
+                GameState generated(rng);
+                const GameState::InitialState& layout = generated.getInitialState();
+                for (int a = 0; a < NUM_ALGORITHMS; a++) playOne(layout, d, options, mine[a]);
+                if (options.progress) options.progress->expand();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++) pool.emplace_back(worker, t);
+        worker(0);
+        for (auto& th : pool) th.join();
+
+        TournamentResult result;
+        result.options = options;
+        for (int a = 0; a < NUM_ALGORITHMS; a++) {
+            result.algorithms[a].planner = algorithmAt(a);
+            for (int t = 0; t < threads; t++) result.algorithms[a].merge(partial[t][a]);
+            result.algorithms[a].finish();
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return result;
+    }
+
+    inline std::string formatTable(const TournamentResult& r) {
+        std::string out;
+        char line[256];
+        snprintf(line, sizeof(line), "Tournament: %llu dungeons (seed %llu), %.2f s\n",
+            (unsigned long long)r.options.dungeons, (unsigned long long)r.options.seed, r.seconds);
+        out += line;
+        snprintf(line, sizeof(line), "%-9s %7s %7s %7s %7s %9s %9s %9s %9s\n",
+            "algorithm", "win%", "solved%", "cost", "gold", "expanded", "p50 us", "p90 us", "p99 us");
+        out += line;
+        for (const AlgorithmStats& a : r.algorithms) {
+            double games = a.games ? (double)a.games : 1.0;
+            snprintf(line, sizeof(line), "%-9s %7.2f %7.2f %7.2f %7.2f %9.1f %9.1f %9.1f %9.1f\n",
+                DungeonHeadless::plannerName(a.planner), a.winRate() * 100.0, a.solved * 100.0 / games,
+                a.meanPathCost(), a.meanGoldAtExit(), a.meanExpansions(), a.timeP50, a.timeP90, a.timeP99);
+            out += line;
+        }
+        out += "expanded: nodes taken off the frontier; for mdp, value-iteration state backups\n";
+        return out;
+    }
+
+    inline void writeCsv(FILE* f, const TournamentResult& r) {
+        fprintf(f, "algorithm,dungeons,seed,solved,wins,poor_exits,win_rate,mean_path_cost,mean_path_length,"
+            "mean_gold_at_exit,mean_expansions,time_mean_us,time_p50_us,time_p90_us,time_p99_us\n");
+        for (const AlgorithmStats& a : r.algorithms) {
+            fprintf(f, "%s,%llu,%llu,%llu,%llu,%llu,%.6f,%.4f,%.4f,%.4f,%.2f,%.3f,%.3f,%.3f,%.3f\n",
+                DungeonHeadless::plannerName(a.planner), (unsigned long long)a.games, (unsigned long long)r.options.seed,
+                (unsigned long long)a.solved, (unsigned long long)a.wins, (unsigned long long)a.poorExits, a.winRate(),
+                a.meanPathCost(), a.meanPathLength(), a.meanGoldAtExit(), a.meanExpansions(),
+                a.timeMean, a.timeP50, a.timeP90, a.timeP99);
+        }
+    }
+
+    inline void writeJson(FILE* f, const TournamentResult& r) {
+        fprintf(f, "{\"dungeons\":%llu,\"seed\":%llu,\"seconds\":%.6f,\"algorithms\":[",
+            (unsigned long long)r.options.dungeons, (unsigned long long)r.options.seed, r.seconds);
+        for (int i = 0; i < NUM_ALGORITHMS; i++) {
+            const AlgorithmStats& a = r.algorithms[i];
+            fprintf(f, "%s{\"algorithm\":\"%s\",\"solved\":%llu,\"wins\":%llu,\"poor_exits\":%llu,\"win_rate\":%.6f,"
+                "\"mean_path_cost\":%.4f,\"mean_gold_at_exit\":%.4f,\"mean_expansions\":%.2f,"
+                "\"time_p50_us\":%.3f,\"time_p90_us\":%.3f,\"time_p99_us\":%.3f}",
+                i ? "," : "", DungeonHeadless::plannerName(a.planner), (unsigned long long)a.solved,
+                (unsigned long long)a.wins, (unsigned long long)a.poorExits, a.winRate(), a.meanPathCost(),
+                a.meanGoldAtExit(), a.meanExpansions(), a.timeP50, a.timeP90, a.timeP99);
+        }
+        fprintf(f, "]}\n");
+    }
+}